@@ -14,3 +14,154 @@
 // Enable periodic heap memory monitoring
 #define APP_LOG_HEAP 1
 #define APP_HEAP_LOG_INTERVAL_MS 60000
+
+// Scene crossfade duration and the RAM reserved for the frozen outgoing frame
+#define APP_CROSSFADE_MS 1200
+#ifndef APP_CROSSFADE_RAM_BUDGET_BYTES
+#define APP_CROSSFADE_RAM_BUDGET_BYTES 4096
+#endif
+
+// Internal render resolution as a percentage of the panel (100, 75 or 50).
+// Below 100% a scene renders into Engine scratch memory and is upscaled
+// while the final framebuffer is written.
+#define APP_RD_GRID_SCALE_PCT 100
+#define APP_CURL_RENDER_SCALE_PCT 100
+
+// Curl noise in Q16.16 integer math instead of float: lattice hashing,
+// fades from a table and an integer direction bucket (see src/Noise.h).
+#ifndef APP_CURL_FIXED_NOISE
+#define APP_CURL_FIXED_NOISE 0
+#endif
+// Evaluate the curl field on a coarse lattice and interpolate it to pixels.
+// The spacing follows the noise scale, 2 to 8 pixels.
+#ifndef APP_CURL_LATTICE
+#define APP_CURL_LATTICE 1
+#endif
+
+// Reaction-diffusion cells as Q1.14 int16_t instead of float: half the grid
+// memory and integer stencils. Both solvers share parameters and palette.
+#ifndef APP_RD_FIXED_POINT
+#define APP_RD_FIXED_POINT 0
+#endif
+// With APP_RD_FIXED_POINT, step two cells at a time with the Cortex-M4 DSP
+// instructions (portable emulation elsewhere, see src/Dsp.h).
+#ifndef APP_RD_DSP_KERNEL
+#define APP_RD_DSP_KERNEL 0
+#endif
+// Sparse RD stepping: an 8x8 tile whose cells all moved less than
+// APP_RD_CALM_DELTA in a step is only stepped every APP_RD_CALM_INTERVAL
+// steps, until a busy neighbouring tile or a raindrop wakes it. An interval
+// of 1 steps every tile every time.
+#ifndef APP_RD_CALM_INTERVAL
+#define APP_RD_CALM_INTERVAL 4
+#endif
+#define APP_RD_CALM_DELTA 0.0005f
+// Write the RD frame from the last step of each update instead of a
+// separate render pass (whole-frame rendering only; strips still render).
+#ifndef APP_RD_FUSED_RENDER
+#define APP_RD_FUSED_RENDER 1
+#endif
+// Step RD with the semi-implicit integrator (src/scenes/RdImplicit.h):
+// APP_RD_IMPLICIT_STEPS large steps per update cover the simulated time of
+// the explicit kernels' 20, and stronger wind is let through. Float cells
+// only; calm tiles are not skipped.
+#ifndef APP_RD_IMPLICIT
+#define APP_RD_IMPLICIT 0
+#endif
+#ifndef APP_RD_IMPLICIT_STEPS
+#define APP_RD_IMPLICIT_STEPS 4
+#endif
+// RD field snapshots in QSPI flash (src/scenes/RdSnapshot.h): written in
+// the background every APP_RD_SNAPSHOT_INTERVAL_MS and restored by begin()
+// instead of reseeding. They rotate through APP_QSPI_SNAPSHOT_BYTES of
+// flash from APP_QSPI_SNAPSHOT_OFFSET, the top 64 KB of the 2 MB chip.
+// Nothing reserves that range: a CircuitPython (or other) filesystem left
+// on the chip spans all of it, so file data stored in its last 64 KB is
+// overwritten, and the filesystem's own writes there cost the snapshots
+// (their CRC rejects them). Set APP_RD_SNAPSHOT to 0 to keep such a
+// filesystem intact. Off target the flash is the file APP_QSPI_HOST_FILE;
+// native tests each pick their own with QspiFlash::setHostFile().
+#ifndef APP_RD_SNAPSHOT
+#define APP_RD_SNAPSHOT 1
+#endif
+#ifndef APP_RD_SNAPSHOT_INTERVAL_MS
+#define APP_RD_SNAPSHOT_INTERVAL_MS 600000UL
+#endif
+#define APP_QSPI_SNAPSHOT_OFFSET 0x1F0000UL
+#define APP_QSPI_SNAPSHOT_BYTES 0x10000UL
+#ifndef APP_QSPI_HOST_FILE
+#define APP_QSPI_HOST_FILE "qspi_flash.bin"
+#endif
+
+// Strip rendering for scenes below panel resolution: Engine renders
+// APP_STRIP_ROWS panel rows at a time through a strip-sized scratch
+// instead of a whole low-resolution frame. 0 keeps whole-frame scratch.
+// This only shrinks scratch: panel-resolution scenes render straight into
+// the framebuffer, which needs no scratch, and are never stripped.
+#ifndef APP_STRIP_ROWS
+#define APP_STRIP_ROWS 0
+#endif
+
+// Panel current limiter. The estimate scales APP_PANEL_FULL_WHITE_MA (all
+// LEDs at full duty) by the frame's bitplane duty; 0 disables the limiter.
+#define APP_POWER_BUDGET_MA 2500
+#define APP_PANEL_FULL_WHITE_MA 4000
+// The estimate comes from the post pass, which panel-resolution frames
+// otherwise skip. The limiter runs it every frame while it is scaling or
+// the last estimate was over three quarters of the budget; below that it
+// measures every APP_LIMITER_PROBE_FRAMES frames, so content that jumps
+// from there to over budget can run over for up to that many frames less
+// one.
+#ifndef APP_LIMITER_PROBE_FRAMES
+#define APP_LIMITER_PROBE_FRAMES 8
+#endif
+
+// Weather overlay: rain, snow and storm flashes composited over every scene
+// when the precipitation probability is above APP_OVERLAY_PRECIP_MIN_PCT.
+#define APP_WEATHER_OVERLAY 1
+#define APP_OVERLAY_MAX_PARTICLES 48
+#define APP_OVERLAY_PRECIP_MIN_PCT 30
+
+// Periodic Engine telemetry (frame rate, estimated current, limiter)
+#define APP_LOG_TELEMETRY 1
+#define APP_TELEMETRY_LOG_INTERVAL_MS 30000
+
+// Power governor: local-time schedule for the day/evening/night profiles
+#define APP_POWER_GOVERNOR 1
+#define APP_DAY_START_HOUR 7
+#define APP_EVENING_START_HOUR 18
+#define APP_NIGHT_START_HOUR 22
+// Used until a weather response reports the location's UTC offset
+#define APP_UTC_OFFSET_MINUTES 0
+#define APP_GOVERNOR_TRANSITION_MS 15000
+
+// Scene warm-up. In cycle mode the next scene is switched in while the
+// panel is dark for a weather fetch and stepped off-screen until developed.
+// Budgets are wall time per loop() pass: while dark, and from spare frame
+// time once visible.
+#define APP_PREWARM_DARK_SLICE_MS 20
+#define APP_PREWARM_SPARE_SLICE_MS 4
+
+// Remote rendering: frames streamed from a host over UDP (src/net/
+// FrameCodec.h) replace the local scenes while they keep arriving. The
+// jitter buffer holds this many complete frames before showing them; local
+// rendering resumes after APP_REMOTE_TIMEOUT_MS without a new frame.
+#ifndef APP_REMOTE_RENDER
+#define APP_REMOTE_RENDER 0
+#endif
+#define APP_REMOTE_PORT 5568
+#define APP_REMOTE_JITTER_FRAMES 2
+#define APP_REMOTE_TIMEOUT_MS 1500
+
+// Performance build (env:perf / env:perf_flash in platformio.ini)
+#ifndef APP_PERF_BUILD
+#define APP_PERF_BUILD 0
+#endif
+// Copy HOT_KERNEL functions to SRAM at boot (perf builds only)
+#ifndef APP_RAM_KERNELS
+#define APP_RAM_KERNELS 0
+#endif
+// Benchmark every scene at boot and print cycle counts
+#ifndef APP_KERNEL_BENCH
+#define APP_KERNEL_BENCH APP_PERF_BUILD
+#endif
@@ -2,19 +2,35 @@
 
 #include <Adafruit_Protomatter.h>
 
-// Matrix Portal M4 + 64x32 HUB75 (known-good pins from prior project).
+// Matrix Portal M4 + HUB75 panels (known-good pins from prior project).
 extern uint8_t kMatrixRgbPins[];
 extern uint8_t kMatrixAddrPins[];
 constexpr uint8_t kMatrixClockPin = 14;
 constexpr uint8_t kMatrixLatchPin = 15;
 constexpr uint8_t kMatrixOePin = 16;
 
-constexpr uint16_t kMatrixWidth = 64;
-constexpr uint8_t kMatrixHeight = 32;
+// Panel geometry, set per build environment in platformio.ini. Panels
+// daisy-chained on the one HUB75 port are a single wider matrix to
+// Protomatter (128x32 is two 64x32 panels); 64x64 panels add the E line.
+#ifndef APP_MATRIX_WIDTH
+#define APP_MATRIX_WIDTH 64
+#endif
+#ifndef APP_MATRIX_HEIGHT
+#define APP_MATRIX_HEIGHT 32
+#endif
+
+constexpr uint16_t kMatrixWidth = APP_MATRIX_WIDTH;
+constexpr uint8_t kMatrixHeight = APP_MATRIX_HEIGHT;
 constexpr uint8_t kMatrixBitplanes = 4;
-constexpr uint8_t kMatrixChains = 1;
-constexpr uint8_t kMatrixAddrLines = 4; // A-D for 32px tall panels
+constexpr uint8_t kMatrixChains = 1; // parallel RGB chains (Protomatter rgbCount)
+// Each address selects two rows per chain: A-D for 32 rows, A-E for 64.
+constexpr uint8_t kMatrixAddrLines =
+    kMatrixHeight / kMatrixChains >= 64 ? 5 : kMatrixHeight / kMatrixChains >= 32 ? 4 : 3;
 constexpr bool kMatrixDoubleBuffer = true;
 
+static_assert(kMatrixWidth % 32 == 0, "Panel chain width must be a multiple of 32");
+static_assert(kMatrixHeight == kMatrixChains * (2u << kMatrixAddrLines),
+              "Panel height must be 16, 32 or 64 rows per chain");
+
 extern const uint8_t kButtonPin;
 extern Adafruit_Protomatter matrix;
@@ -0,0 +1,16 @@
+# PlatformIO pre-script for the perf environments: compile scene kernels at
+# -O3 (the rest of the firmware keeps the framework's -Os) and link with LTO.
+Import("env")
+
+KERNEL_DIRS = ("scenes",)
+
+
+def kernel_opt(env, node):
+    path = node.get_path().replace("\\", "/")
+    if any("src/%s/" % d in path for d in KERNEL_DIRS):
+        return env.Object(node, CCFLAGS=env["CCFLAGS"] + ["-O3"])
+    return node
+
+
+env.AddBuildMiddleware(kernel_opt)
+env.Append(LINKFLAGS=["-flto", "-O2"])
@@ -0,0 +1,268 @@
+#include "BufferOps.h"
+
+#include <string.h>
+
+namespace BufferOps {
+namespace {
+Fence submitted_ = 0;
+Fence completed_ = 0;
+
+void fill16Cpu(uint16_t *dst, uint16_t value, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = value;
+  }
+}
+
+void fill32Cpu(uint32_t *dst, uint32_t value, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    dst[i] = value;
+  }
+}
+
+void copy2DCpu(uint8_t *dst, size_t dst_stride, const uint8_t *src, size_t src_stride,
+               size_t row_bytes, size_t rows) {
+  for (size_t y = 0; y < rows; ++y) {
+    memcpy(dst + y * dst_stride, src + y * src_stride, row_bytes);
+  }
+}
+
+Fence completeSync() {
+  completed_ = ++submitted_;
+  return submitted_;
+}
+} // namespace
+} // namespace BufferOps
+
+#if defined(__SAMD51__)
+
+namespace BufferOps {
+namespace {
+constexpr uint8_t kChannel = 0;
+// Linked descriptors for copy2D (one per row beyond the first).
+constexpr size_t kMaxLinked = 64;
+constexpr uint32_t kMaxBeats = 0xFFFF;
+
+__attribute__((aligned(16))) DmacDescriptor base_descriptor_[kChannel + 1];
+__attribute__((aligned(16))) DmacDescriptor writeback_[kChannel + 1];
+__attribute__((aligned(16))) DmacDescriptor linked_[kMaxLinked];
+
+volatile uint32_t fill_word_ = 0;
+bool async_ = false;
+bool busy_ = false;
+
+bool channelIdle() {
+  const uint8_t flags = DMAC->Channel[kChannel].CHINTFLAG.reg;
+  return (flags & (DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR)) != 0;
+}
+
+void retire() {
+  if (busy_) {
+    while (!channelIdle()) {
+    }
+    DMAC->Channel[kChannel].CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR;
+    busy_ = false;
+  }
+  completed_ = submitted_;
+}
+
+// Beat size for a transfer given the alignment of everything involved.
+uint8_t beatBytes(uintptr_t a, uintptr_t b, size_t bytes) {
+  const uintptr_t bits = a | b | bytes;
+  if ((bits & 3) == 0) {
+    return 4;
+  }
+  if ((bits & 1) == 0) {
+    return 2;
+  }
+  return 1;
+}
+
+uint16_t beatSizeBits(uint8_t beat) {
+  if (beat == 4) {
+    return DMAC_BTCTRL_BEATSIZE_WORD;
+  }
+  if (beat == 2) {
+    return DMAC_BTCTRL_BEATSIZE_HWORD;
+  }
+  return DMAC_BTCTRL_BEATSIZE_BYTE;
+}
+
+// Incrementing addresses are programmed as the end of the block.
+void describe(DmacDescriptor &d, void *dst, const volatile void *src, size_t bytes,
+              uint8_t beat, bool src_inc, DmacDescriptor *next) {
+  uint16_t ctrl = DMAC_BTCTRL_VALID | DMAC_BTCTRL_DSTINC | beatSizeBits(beat);
+  if (src_inc) {
+    ctrl |= DMAC_BTCTRL_SRCINC;
+  }
+  ctrl |= next ? DMAC_BTCTRL_BLOCKACT_NOACT : DMAC_BTCTRL_BLOCKACT_INT;
+  d.BTCTRL.reg = ctrl;
+  d.BTCNT.reg = (uint16_t)(bytes / beat);
+  d.SRCADDR.reg = (uint32_t)src + (src_inc ? bytes : 0);
+  d.DSTADDR.reg = (uint32_t)dst + bytes;
+  d.DESCADDR.reg = (uint32_t)next;
+}
+
+Fence start() {
+  DMAC->Channel[kChannel].CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL | DMAC_CHINTFLAG_TERR;
+  DMAC->Channel[kChannel].CHCTRLA.bit.ENABLE = 1;
+  DMAC->SWTRIGCTRL.reg |= (1UL << kChannel);
+  busy_ = true;
+  return ++submitted_;
+}
+} // namespace
+
+void begin() {
+  // Leave the DMAC alone if something else already owns it.
+  if (DMAC->CTRL.bit.DMAENABLE) {
+    Serial.println("BufferOps: DMAC in use, using CPU copies");
+    return;
+  }
+
+  MCLK->AHBMASK.bit.DMAC_ = 1;
+  DMAC->CTRL.bit.SWRST = 1;
+  while (DMAC->CTRL.bit.SWRST) {
+  }
+  DMAC->BASEADDR.reg = (uint32_t)base_descriptor_;
+  DMAC->WRBADDR.reg = (uint32_t)writeback_;
+  DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+
+  DMAC->Channel[kChannel].CHCTRLA.bit.ENABLE = 0;
+  DMAC->Channel[kChannel].CHCTRLA.bit.SWRST = 1;
+  while (DMAC->Channel[kChannel].CHCTRLA.bit.SWRST) {
+  }
+  DMAC->Channel[kChannel].CHPRILVL.reg = 0;
+  // Software trigger; one trigger runs the whole descriptor chain.
+  DMAC->Channel[kChannel].CHCTRLA.reg =
+      DMAC_CHCTRLA_TRIGSRC(0) | DMAC_CHCTRLA_TRIGACT_TRANSACTION | DMAC_CHCTRLA_BURSTLEN_SINGLE;
+  async_ = true;
+}
+
+bool isAsync() {
+  return async_;
+}
+
+Fence fill16(uint16_t *dst, uint16_t value, size_t count) {
+  if (!async_ || count == 0 || count > kMaxBeats) {
+    retire();
+    fill16Cpu(dst, value, count);
+    return completeSync();
+  }
+  retire();
+  fill_word_ = value;
+  describe(base_descriptor_[kChannel], dst, &fill_word_, count * 2, 2, false, nullptr);
+  return start();
+}
+
+Fence fill32(uint32_t *dst, uint32_t value, size_t count) {
+  if (!async_ || count == 0 || count > kMaxBeats) {
+    retire();
+    fill32Cpu(dst, value, count);
+    return completeSync();
+  }
+  retire();
+  fill_word_ = value;
+  describe(base_descriptor_[kChannel], dst, &fill_word_, count * 4, 4, false, nullptr);
+  return start();
+}
+
+Fence copy(void *dst, const void *src, size_t bytes) {
+  const uint8_t beat = beatBytes((uintptr_t)dst, (uintptr_t)src, bytes);
+  if (!async_ || bytes == 0 || bytes / beat > kMaxBeats) {
+    retire();
+    memcpy(dst, src, bytes);
+    return completeSync();
+  }
+  retire();
+  describe(base_descriptor_[kChannel], dst, src, bytes, beat, true, nullptr);
+  return start();
+}
+
+Fence copy2D(void *dst, size_t dst_stride, const void *src, size_t src_stride,
+             size_t row_bytes, size_t rows) {
+  uint8_t *d = static_cast<uint8_t *>(dst);
+  const uint8_t *s = static_cast<const uint8_t *>(src);
+  const uint8_t beat = beatBytes((uintptr_t)d | dst_stride, (uintptr_t)s | src_stride, row_bytes);
+  if (!async_ || rows == 0 || row_bytes == 0 || rows > kMaxLinked + 1 ||
+      row_bytes / beat > kMaxBeats) {
+    retire();
+    copy2DCpu(d, dst_stride, s, src_stride, row_bytes, rows);
+    return completeSync();
+  }
+  retire();
+  // Row 0 lives in the channel's base descriptor, the rest are chained.
+  for (size_t y = rows - 1; y > 0; --y) {
+    DmacDescriptor *next = (y + 1 < rows) ? &linked_[y] : nullptr;
+    describe(linked_[y - 1], d + y * dst_stride, s + y * src_stride, row_bytes, beat, true, next);
+  }
+  describe(base_descriptor_[kChannel], d, s, row_bytes, beat, true,
+           rows > 1 ? &linked_[0] : nullptr);
+  return start();
+}
+
+bool done(Fence fence) {
+  if ((int32_t)(completed_ - fence) >= 0) {
+    return true;
+  }
+  if (busy_ && channelIdle()) {
+    retire();
+  }
+  return (int32_t)(completed_ - fence) >= 0;
+}
+
+void wait(Fence fence) {
+  if ((int32_t)(completed_ - fence) < 0) {
+    retire();
+  }
+}
+
+void waitAll() {
+  retire();
+}
+
+} // namespace BufferOps
+
+#else
+
+namespace BufferOps {
+
+void begin() {}
+
+bool isAsync() {
+  return false;
+}
+
+Fence fill16(uint16_t *dst, uint16_t value, size_t count) {
+  fill16Cpu(dst, value, count);
+  return completeSync();
+}
+
+Fence fill32(uint32_t *dst, uint32_t value, size_t count) {
+  fill32Cpu(dst, value, count);
+  return completeSync();
+}
+
+Fence copy(void *dst, const void *src, size_t bytes) {
+  memcpy(dst, src, bytes);
+  return completeSync();
+}
+
+Fence copy2D(void *dst, size_t dst_stride, const void *src, size_t src_stride,
+             size_t row_bytes, size_t rows) {
+  copy2DCpu(static_cast<uint8_t *>(dst), dst_stride, static_cast<const uint8_t *>(src),
+            src_stride, row_bytes, rows);
+  return completeSync();
+}
+
+bool done(Fence fence) {
+  return (int32_t)(completed_ - fence) >= 0;
+}
+
+void wait(Fence fence) {
+  (void)fence;
+}
+
+void waitAll() {}
+
+} // namespace BufferOps
+
+#endif
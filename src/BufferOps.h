@@ -0,0 +1,29 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Whole-buffer fills and copies, run on the SAMD51 DMAC so the CPU can
+// keep simulating while memory moves. Operations are queued one at a time
+// on a single channel; each returns a fence to wait on before touching the
+// destination. Builds without the DMAC run them synchronously.
+namespace BufferOps {
+
+using Fence = uint32_t;
+
+void begin();
+
+Fence fill16(uint16_t *dst, uint16_t value, size_t count);
+Fence fill32(uint32_t *dst, uint32_t value, size_t count);
+Fence copy(void *dst, const void *src, size_t bytes);
+// Copies `rows` rows of `row_bytes`, advancing each side by its stride.
+Fence copy2D(void *dst, size_t dst_stride, const void *src, size_t src_stride,
+             size_t row_bytes, size_t rows);
+
+bool done(Fence fence);
+void wait(Fence fence);
+void waitAll();
+
+// True when transfers run on the DMAC rather than the CPU fallback.
+bool isAsync();
+
+} // namespace BufferOps
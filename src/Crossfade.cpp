@@ -0,0 +1,38 @@
+#include "Crossfade.h"
+
+#include "BufferOps.h"
+
+Crossfade::Crossfade()
+    : snapshot_{}, duration_ms_(0), elapsed_ms_(0), active_(false) {}
+
+void Crossfade::begin(const uint16_t *frame, uint32_t duration_ms) {
+  if (!frame || duration_ms == 0) {
+    active_ = false;
+    return;
+  }
+  BufferOps::copy(snapshot_, frame, sizeof(snapshot_));
+  duration_ms_ = duration_ms;
+  elapsed_ms_ = 0;
+  active_ = true;
+}
+
+void Crossfade::advance(uint32_t dt_ms) {
+  if (!active_) {
+    return;
+  }
+  elapsed_ms_ += dt_ms;
+  if (elapsed_ms_ >= duration_ms_) {
+    active_ = false;
+  }
+}
+
+void Crossfade::cancel() {
+  active_ = false;
+}
+
+uint8_t Crossfade::alpha5() const {
+  if (!active_) {
+    return 32;
+  }
+  return (uint8_t)((elapsed_ms_ * 32UL) / duration_ms_);
+}
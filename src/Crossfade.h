@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+
+// Timed blend from a frozen copy of the outgoing scene's last frame to the
+// live output of the incoming scene. Only the 565 frame is kept, never the
+// outgoing scene's state; Engine applies the blend in its post pass.
+class Crossfade {
+public:
+  static constexpr size_t kSnapshotPixels = (size_t)kMatrixWidth * kMatrixHeight;
+
+  Crossfade();
+
+  // Freezes `frame` (kSnapshotPixels of RGB565) and restarts the fade.
+  void begin(const uint16_t *frame, uint32_t duration_ms);
+  void advance(uint32_t dt_ms);
+  void cancel();
+
+  bool active() const { return active_; }
+  // Weight of the incoming frame, 0 (all snapshot) to 32 (all live).
+  uint8_t alpha5() const;
+  const uint16_t *snapshot() const { return snapshot_; }
+
+  // Blends one RGB565 pixel pair; `alpha5` weights `live` in 0..32.
+  static inline uint16_t blend565(uint16_t frozen, uint16_t live, uint8_t alpha5) {
+    // Spread 565 into 0b00000gggggg00000rrrrr000000bbbbb so all three
+    // channels are scaled with a single multiply.
+    const uint32_t s = ((uint32_t)frozen | ((uint32_t)frozen << 16)) & 0x07E0F81FUL;
+    const uint32_t l = ((uint32_t)live | ((uint32_t)live << 16)) & 0x07E0F81FUL;
+    const uint32_t m = ((((l - s) * alpha5) >> 5) + s) & 0x07E0F81FUL;
+    return (uint16_t)(m | (m >> 16));
+  }
+
+private:
+  uint16_t snapshot_[kSnapshotPixels];
+  uint32_t duration_ms_;
+  uint32_t elapsed_ms_;
+  bool active_;
+};
+
+static_assert(sizeof(uint16_t) * Crossfade::kSnapshotPixels <= APP_CROSSFADE_RAM_BUDGET_BYTES,
+              "Crossfade snapshot exceeds APP_CROSSFADE_RAM_BUDGET_BYTES");
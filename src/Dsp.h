@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP)
+#include <cmsis_compiler.h>
+#endif
+
+// Packed-halfword (SIMD) and saturating operations from the Cortex-M4 DSP
+// extension. On cores with the extension these are the CMSIS intrinsics;
+// elsewhere a portable implementation with the same results, so kernels
+// written against Dsp:: build and can be checked bit-for-bit off target.
+//
+// A packed word holds two int16_t lanes: lane 0 in the low halfword.
+namespace Dsp {
+
+inline int16_t lo(uint32_t x) {
+  return (int16_t)(x & 0xFFFF);
+}
+
+inline int16_t hi(uint32_t x) {
+  return (int16_t)(x >> 16);
+}
+
+// Two adjacent halfwords from memory; unaligned loads are fine on the M4.
+inline uint32_t load2(const int16_t *p) {
+  uint32_t x;
+  memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+inline void store2(int16_t *p, uint32_t x) {
+  memcpy(p, &x, sizeof(x));
+}
+
+#if defined(__ARM_FEATURE_DSP)
+
+inline uint32_t pack(int32_t lane0, int32_t lane1) {
+  return __PKHBT((uint32_t)lane0, (uint32_t)lane1, 16);
+}
+inline uint32_t qadd16(uint32_t a, uint32_t b) {
+  return __QADD16(a, b);
+}
+inline uint32_t qsub16(uint32_t a, uint32_t b) {
+  return __QSUB16(a, b);
+}
+inline uint32_t shadd16(uint32_t a, uint32_t b) {
+  return __SHADD16(a, b);
+}
+inline int32_t smlad(uint32_t a, uint32_t b, int32_t acc) {
+  return (int32_t)__SMLAD(a, b, (uint32_t)acc);
+}
+template <uint8_t Bits>
+inline int32_t usat(int32_t x) {
+  return (int32_t)__USAT(x, Bits);
+}
+template <uint8_t Bits>
+inline int32_t ssat(int32_t x) {
+  return __SSAT(x, Bits);
+}
+
+#else
+
+// Clamps to [0, 2^Bits - 1].
+template <uint8_t Bits>
+inline int32_t usat(int32_t x) {
+  return x < 0 ? 0 : (x > (int32_t)((1UL << Bits) - 1) ? (int32_t)((1UL << Bits) - 1) : x);
+}
+// Clamps to [-2^(Bits - 1), 2^(Bits - 1) - 1].
+template <uint8_t Bits>
+inline int32_t ssat(int32_t x) {
+  return x < -(1L << (Bits - 1)) ? (int32_t)-(1L << (Bits - 1))
+                                 : (x > (1L << (Bits - 1)) - 1 ? (int32_t)((1L << (Bits - 1)) - 1) : x);
+}
+
+inline uint32_t pack(int32_t lane0, int32_t lane1) {
+  return ((uint32_t)lane0 & 0xFFFF) | ((uint32_t)lane1 << 16);
+}
+inline uint32_t qadd16(uint32_t a, uint32_t b) {
+  return pack(ssat<16>(lo(a) + lo(b)), ssat<16>(hi(a) + hi(b)));
+}
+inline uint32_t qsub16(uint32_t a, uint32_t b) {
+  return pack(ssat<16>(lo(a) - lo(b)), ssat<16>(hi(a) - hi(b)));
+}
+// Halving add: (a + b) >> 1 per lane, rounding toward minus infinity.
+inline uint32_t shadd16(uint32_t a, uint32_t b) {
+  return pack((lo(a) + lo(b)) >> 1, (hi(a) + hi(b)) >> 1);
+}
+// Dual multiply-accumulate: acc + a.lane0 * b.lane0 + a.lane1 * b.lane1,
+// wrapping like the hardware.
+inline int32_t smlad(uint32_t a, uint32_t b, int32_t acc) {
+  return (int32_t)((uint32_t)acc + (uint32_t)((int32_t)lo(a) * lo(b)) +
+                   (uint32_t)((int32_t)hi(a) * hi(b)));
+}
+
+#endif
+
+} // namespace Dsp
@@ -1,15 +1,187 @@
 #include "Engine.h"
 
+#include "BoardConfig.h"
+#include "BufferOps.h"
+
+namespace {
+// Protomatter shows only the top kMatrixBitplanes bits of each channel, so
+// LED duty (and current) follows those bits.
+constexpr uint8_t kRedShift = 5 - kMatrixBitplanes;
+constexpr uint8_t kGreenShift = 6 - kMatrixBitplanes;
+constexpr uint8_t kBlueShift = 5 - kMatrixBitplanes;
+constexpr uint32_t kMaxLevel = (1UL << kMatrixBitplanes) - 1;
+constexpr uint32_t kFullLevelSum = (uint32_t)kMatrixWidth * kMatrixHeight * 3 * kMaxLevel;
+
+// Limiter release per frame (q8); reductions apply on the next frame.
+constexpr uint16_t kLimiterReleaseQ8 = 4;
+// Above this estimate the limiter measures every frame.
+constexpr uint32_t kLimiterWatchMa = (uint32_t)APP_POWER_BUDGET_MA * 3 / 4;
+static_assert(APP_LIMITER_PROBE_FRAMES > 0 && APP_LIMITER_PROBE_FRAMES < 256,
+              "APP_LIMITER_PROBE_FRAMES must fit the frame counter");
+
+uint16_t levelSumToMa(uint32_t level_sum) {
+  return (uint16_t)(((uint64_t)level_sum * APP_PANEL_FULL_WHITE_MA) / kFullLevelSum);
+}
+
+// Source rows behind panel rows [y0, y1), padded by one row each side for
+// the bilinear neighbour and the nearest sampler's rounded-down step.
+void stripSourceRows(const RenderSpec &spec, uint16_t y0, uint16_t y1, uint16_t &first,
+                     uint16_t &count) {
+  const uint32_t lo = (uint32_t)y0 * spec.height / kMatrixHeight;
+  uint32_t hi = ((uint32_t)y1 * spec.height + kMatrixHeight - 1) / kMatrixHeight + 1;
+  if (hi > spec.height) {
+    hi = spec.height;
+  }
+  first = (uint16_t)(lo > 0 ? lo - 1 : 0);
+  count = (uint16_t)(hi - first);
+}
+
+// Samplers produce one RGB565 panel pixel at a time, left to right, from the
+// scene's target. Source positions are stepped in 16.16 fixed point so
+// there is no per-pixel divide.
+
+struct DirectSampler {
+  const uint16_t *src;
+  const uint16_t *row;
+
+  void beginRow(uint16_t y) {
+    row = src + (uint32_t)y * kMatrixWidth;
+  }
+  uint16_t sample(uint16_t x) {
+    return row[x];
+  }
+};
+
+template <PixelFormat Format>
+struct NearestSampler {
+  const RenderTarget &target;
+  uint32_t step_x;
+  uint32_t step_y;
+  uint32_t pos_x;
+  const uint16_t *rgb_row;
+  const uint8_t *index_row;
+
+  explicit NearestSampler(const RenderTarget &t)
+      : target(t),
+        step_x(((uint32_t)t.width << 16) / kMatrixWidth),
+        step_y(((uint32_t)t.height << 16) / kMatrixHeight),
+        pos_x(0), rgb_row(nullptr), index_row(nullptr) {}
+
+  void beginRow(uint16_t y) {
+    const uint32_t sy = ((uint32_t)y * step_y) >> 16;
+    if (Format == PixelFormat::kRgb565) {
+      rgb_row = target.rgb + (sy - target.row0) * target.width;
+    } else {
+      index_row = target.index + (sy - target.row0) * target.width;
+    }
+    pos_x = 0;
+  }
+  uint16_t sample(uint16_t x) {
+    (void)x;
+    const uint32_t sx = pos_x >> 16;
+    pos_x += step_x;
+    if (Format == PixelFormat::kRgb565) {
+      return rgb_row[sx];
+    }
+    return target.palette[index_row[sx]];
+  }
+};
+
+template <PixelFormat Format>
+struct BilinearSampler {
+  const RenderTarget &target;
+  int32_t step_x;
+  int32_t step_y;
+  int32_t start_x;
+  int32_t pos_x;
+  uint16_t fy;        // 0-256
+  uint32_t row0;
+  uint32_t row1;
+
+  explicit BilinearSampler(const RenderTarget &t)
+      : target(t),
+        step_x((int32_t)(((uint32_t)t.width << 16) / kMatrixWidth)),
+        step_y((int32_t)(((uint32_t)t.height << 16) / kMatrixHeight)),
+        start_x(step_x / 2 - 0x8000), pos_x(0), fy(0), row0(0), row1(0) {}
+
+  // Pixel-center mapping, clamped at the edges.
+  static void split(int32_t pos, uint16_t size, uint32_t &i0, uint32_t &i1, uint16_t &frac) {
+    if (pos <= 0) {
+      i0 = 0;
+      i1 = 0;
+      frac = 0;
+      return;
+    }
+    i0 = (uint32_t)pos >> 16;
+    if (i0 >= (uint32_t)(size - 1)) {
+      i0 = size - 1;
+      i1 = i0;
+      frac = 0;
+      return;
+    }
+    i1 = i0 + 1;
+    frac = (uint16_t)(((uint32_t)pos >> 8) & 0xFF);
+  }
+
+  void beginRow(uint16_t y) {
+    uint32_t y0, y1;
+    split(step_y / 2 - 0x8000 + (int32_t)y * step_y, target.height, y0, y1, fy);
+    row0 = (y0 - target.row0) * target.width;
+    row1 = (y1 - target.row0) * target.width;
+    pos_x = start_x;
+  }
+
+  uint16_t sample(uint16_t x) {
+    (void)x;
+    uint32_t x0, x1;
+    uint16_t fx;
+    split(pos_x, target.width, x0, x1, fx);
+    pos_x += step_x;
+
+    if (Format == PixelFormat::kRgb565) {
+      const uint16_t *p = target.rgb;
+      const uint16_t top = Crossfade::blend565(p[row0 + x0], p[row0 + x1], (uint8_t)(fx >> 3));
+      const uint16_t bottom = Crossfade::blend565(p[row1 + x0], p[row1 + x1], (uint8_t)(fx >> 3));
+      return Crossfade::blend565(top, bottom, (uint8_t)(fy >> 3));
+    }
+
+    const uint8_t *p = target.index;
+    const uint32_t top = (uint32_t)p[row0 + x0] * (256 - fx) + (uint32_t)p[row0 + x1] * fx;
+    const uint32_t bottom = (uint32_t)p[row1 + x0] * (256 - fx) + (uint32_t)p[row1 + x1] * fx;
+    return target.palette[(top * (256 - fy) + bottom * fy) >> 16];
+  }
+};
+} // namespace
+
 Engine::Engine(Adafruit_Protomatter &matrix, uint32_t frame_interval_ms)
     : matrix_(matrix),
       scene_(nullptr),
+      crossfade_(nullptr),
+      overlay_(nullptr),
       frame_interval_ms_(frame_interval_ms),
-      last_frame_ms_(0) {}
+      last_frame_ms_(0),
+      warned_spec_(false),
+      limiter_q8_(256),
+      unmeasured_frames_(APP_LIMITER_PROBE_FRAMES),
+      stats_{},
+      scratch_{} {}
 
 void Engine::setScene(Scene *scene) {
   scene_ = scene;
 }
 
+void Engine::setCrossfade(Crossfade *crossfade) {
+  crossfade_ = crossfade;
+}
+
+void Engine::setOverlay(WeatherOverlay *overlay) {
+  overlay_ = overlay;
+}
+
+void Engine::setFrameInterval(uint32_t frame_interval_ms) {
+  frame_interval_ms_ = frame_interval_ms;
+}
+
 void Engine::begin() {
   if (scene_) {
     scene_->begin(matrix_);
@@ -27,43 +199,285 @@ void Engine::tick(uint32_t now_ms, float dimmer) {
 
   uint32_t dt_ms = (last_frame_ms_ == 0) ? frame_interval_ms_
                                          : (now_ms - last_frame_ms_);
-  if (dt_ms > 100) {
-    dt_ms = 100;
+  if (dt_ms > Scene::kMaxUpdateMs) {
+    dt_ms = Scene::kMaxUpdateMs;
   }
   last_frame_ms_ = now_ms;
 
-  scene_->update(dt_ms);
-  scene_->render(matrix_);
+  const RenderSpec spec = scene_->renderSpec();
+  // Strips only save scratch; a panel-size frame has none to save.
+  const bool strips = APP_STRIP_ROWS > 0 && !spec.isPanel() && scene_->supportsRowRange();
+  RenderTarget target{};
+  if (!strips && !prepareTarget(spec, target)) {
+    return;
+  }
 
-  // Apply Global Dimming (e.g. for weather fetch fade-out)
-  if (dimmer < 0.99f) {
-    if (dimmer <= 0.01f) {
-      matrix_.fillScreen(0);
-    } else {
-      // Fixed-point scale (0-256)
-      const uint16_t scale = (uint16_t)(dimmer * 256.0f);
-      const int16_t w = matrix_.width();
-      const int16_t h = matrix_.height();
-      
-      for(int16_t y=0; y<h; ++y) {
-        for(int16_t x=0; x<w; ++x) {
-          uint16_t color = matrix_.getPixel(x, y);
-          // Unpack 565
-          uint32_t r = (color >> 11) & 0x1F;
-          uint32_t g = (color >> 5) & 0x3F;
-          uint32_t b = color & 0x1F;
-          
-          // Scale
-          r = (r * scale) >> 8;
-          g = (g * scale) >> 8;
-          b = (b * scale) >> 8;
-          
-          // Repack
-          matrix_.drawPixel(x, y, (uint16_t)((r << 11) | (g << 5) | b));
-        }
+  // Nothing may draw while an earlier transfer still targets the buffers.
+  BufferOps::waitAll();
+  if (overlay_) {
+    overlay_->update(dt_ms);
+  }
+  if (strips) {
+    scene_->update(dt_ms);
+    renderStrips(spec, dimmer);
+  } else {
+    scene_->updateAndRender(dt_ms, target);
+    // Scenes may hand their final copy to the DMAC; it must land before the
+    // post pass reads the frame and show() converts it.
+    BufferOps::waitAll();
+    resolve(target, spec.upscale, dimmer);
+  }
+  if (crossfade_) {
+    crossfade_->advance(dt_ms);
+  }
+
+  BufferOps::waitAll();
+  matrix_.show();
+}
+
+uint32_t Engine::idleMs(uint32_t now_ms) const {
+  const uint32_t elapsed = now_ms - last_frame_ms_;
+  return elapsed >= frame_interval_ms_ ? 0 : frame_interval_ms_ - elapsed;
+}
+
+bool Engine::prepareTarget(const RenderSpec &spec, RenderTarget &target) {
+  target.width = spec.width;
+  target.height = spec.height;
+  target.format = spec.format;
+  target.rgb = nullptr;
+  target.index = nullptr;
+  target.palette = nullptr;
+
+  if (spec.isPanel()) {
+    target.rgb = matrix_.getBuffer();
+    return true;
+  }
+
+  if (!spec.fitsScratch() || spec.width == 0 || spec.height == 0) {
+    if (!warned_spec_) {
+      Serial.print("Engine: unsupported render spec ");
+      Serial.print(spec.width);
+      Serial.print("x");
+      Serial.println(spec.height);
+      warned_spec_ = true;
+    }
+    return false;
+  }
+
+  if (spec.format == PixelFormat::kRgb565) {
+    target.rgb = scratch_;
+  } else {
+    target.index = reinterpret_cast<uint8_t *>(scratch_);
+  }
+  return true;
+}
+
+// Renders a below-panel-resolution frame a strip at a time: the scene fills
+// the source rows behind APP_STRIP_ROWS panel rows into scratch, and they
+// are upscaled and post-processed into the framebuffer before the next
+// strip reuses the buffer.
+void Engine::renderStrips(const RenderSpec &spec, float dimmer) {
+  PostParams post{};
+  if (!beginResolve(false, dimmer, post)) {
+    return;
+  }
+
+  RenderTarget target{};
+  target.width = spec.width;
+  target.height = spec.height;
+  target.format = spec.format;
+  if (spec.format == PixelFormat::kRgb565) {
+    target.rgb = scratch_;
+  } else {
+    target.index = reinterpret_cast<uint8_t *>(scratch_);
+  }
+  const uint16_t row_bytes = (uint16_t)(spec.width * (spec.format == PixelFormat::kRgb565 ? 2 : 1));
+
+  uint32_t level_sum = 0;
+  for (uint16_t y = 0; y < kMatrixHeight; y += APP_STRIP_ROWS) {
+    const uint16_t y_end = (uint16_t)(y + APP_STRIP_ROWS < kMatrixHeight ? y + APP_STRIP_ROWS
+                                                                         : kMatrixHeight);
+    uint16_t first = 0;
+    uint16_t rows = 0;
+    stripSourceRows(spec, y, y_end, first, rows);
+    if ((size_t)rows * row_bytes > sizeof(scratch_)) {
+      if (!warned_spec_) {
+        Serial.println("Engine: strip does not fit scratch");
+        warned_spec_ = true;
       }
+      return;
     }
+    target.row0 = first;
+    scene_->renderRows(target, first, rows);
+    BufferOps::waitAll();
+    level_sum += resolveRows(target, spec.upscale, post, y, y_end);
   }
+  finishResolve(level_sum, post);
+}
 
-  matrix_.show();
+void Engine::resolve(const RenderTarget &target, Upscale upscale, float dimmer) {
+  PostParams post{};
+  if (!beginResolve(target.rgb == matrix_.getBuffer(), dimmer, post)) {
+    return;
+  }
+  finishResolve(resolveRows(target, upscale, post, 0, kMatrixHeight), post);
+}
+
+// Sets up the post pass for this frame. Returns false when there is
+// nothing to do per pixel: a pass-through frame, or a fully dimmed one
+// (cleared here).
+bool Engine::beginResolve(bool direct, float dimmer, PostParams &post) {
+  const bool fading = crossfade_ && crossfade_->active();
+  const bool dimming = dimmer < 0.99f;
+  const bool limiting = limiterNeedsPass();
+  const bool overlaying = overlay_ && overlay_->visible();
+  stats_.frames++;
+  if (direct && !fading && !dimming && !limiting && !overlaying) {
+    return false;
+  }
+
+  // Apply Global Dimming (e.g. for weather fetch fade-out)
+  if (dimmer <= 0.01f) {
+    BufferOps::fill16(matrix_.getBuffer(), 0, (size_t)kMatrixWidth * kMatrixHeight);
+    stats_.demand_ma = 0;
+    stats_.estimated_ma = 0;
+    return false;
+  }
+
+  // Fixed-point scale (0-256)
+  post.dimmer_q8 = dimming ? (uint16_t)(dimmer * 256.0f) : 256;
+  post.frozen = fading ? crossfade_->snapshot() : nullptr;
+  post.alpha5 = fading ? crossfade_->alpha5() : 32;
+  post.overlay = overlaying ? overlay_ : nullptr;
+  post.scale = (uint16_t)(((uint32_t)post.dimmer_q8 * limiter_q8_) >> 8);
+  if (limiter_q8_ < 256) {
+    stats_.limited_frames++;
+  }
+  return true;
+}
+
+// Whether the limiter wants this frame measured: always while it is
+// scaling or the last estimate was near the budget, otherwise every
+// APP_LIMITER_PROBE_FRAMES frames.
+bool Engine::limiterNeedsPass() {
+  if (APP_POWER_BUDGET_MA <= 0) {
+    return false;
+  }
+  if (limiter_q8_ < 256 || stats_.demand_ma > kLimiterWatchMa) {
+    return true;
+  }
+  if (unmeasured_frames_ < APP_LIMITER_PROBE_FRAMES) {
+    unmeasured_frames_++;
+  }
+  return unmeasured_frames_ >= APP_LIMITER_PROBE_FRAMES;
+}
+
+uint32_t Engine::resolveRows(const RenderTarget &target, Upscale upscale, const PostParams &post,
+                             uint16_t y0, uint16_t y1) {
+  if (target.rgb == matrix_.getBuffer()) {
+    DirectSampler sampler{target.rgb, nullptr};
+    return resolveWith(sampler, post, y0, y1);
+  }
+  if (target.format == PixelFormat::kRgb565) {
+    if (upscale == Upscale::kBilinear) {
+      BilinearSampler<PixelFormat::kRgb565> sampler(target);
+      return resolveWith(sampler, post, y0, y1);
+    }
+    NearestSampler<PixelFormat::kRgb565> sampler(target);
+    return resolveWith(sampler, post, y0, y1);
+  }
+  if (target.palette) {
+    if (upscale == Upscale::kBilinear) {
+      BilinearSampler<PixelFormat::kIndexed8> sampler(target);
+      return resolveWith(sampler, post, y0, y1);
+    }
+    NearestSampler<PixelFormat::kIndexed8> sampler(target);
+    return resolveWith(sampler, post, y0, y1);
+  }
+  return 0;
+}
+
+void Engine::finishResolve(uint32_t level_sum, const PostParams &post) {
+  stats_.post_frames++;
+  unmeasured_frames_ = 0;
+  updateLimiter(level_sum, post.dimmer_q8);
+  stats_.estimated_ma = (uint16_t)(((uint32_t)stats_.demand_ma * post.scale) >> 8);
+}
+
+// Picks the global scale for the next frame from this frame's estimated
+// draw: cut immediately when over budget, recover slowly.
+void Engine::updateLimiter(uint32_t level_sum, uint16_t dimmer_q8) {
+  stats_.demand_ma = levelSumToMa(level_sum);
+  if (APP_POWER_BUDGET_MA <= 0) {
+    stats_.limiter_pct = 100;
+    return;
+  }
+
+  const uint32_t dimmed_ma = ((uint32_t)stats_.demand_ma * dimmer_q8) >> 8;
+  uint16_t target_q8 = 256;
+  if (dimmed_ma > (uint32_t)APP_POWER_BUDGET_MA) {
+    target_q8 = (uint16_t)(((uint32_t)APP_POWER_BUDGET_MA << 8) / dimmed_ma);
+  }
+
+  if (target_q8 < limiter_q8_) {
+    limiter_q8_ = target_q8;
+  } else if (limiter_q8_ < target_q8) {
+    limiter_q8_ = (uint16_t)(limiter_q8_ + kLimiterReleaseQ8);
+    if (limiter_q8_ > target_q8) {
+      limiter_q8_ = target_q8;
+    }
+  }
+  stats_.limiter_pct = (uint8_t)(((uint32_t)limiter_q8_ * 100) >> 8);
+}
+
+// Final framebuffer write for panel rows [y0, y1): sample (and upscale) the
+// scene's target, crossfade against the frozen frame (one extra read per
+// pixel), composite the weather overlay inside its dirty span, then dim.
+// Returns the rows' bitplane level sum before scaling, for the current
+// estimate.
+template <typename Sampler>
+uint32_t Engine::resolveWith(Sampler &sampler, const PostParams &post, uint16_t y0, uint16_t y1) {
+  uint16_t *buffer = matrix_.getBuffer();
+  uint32_t level_sum = 0;
+
+  for (uint16_t y = y0; y < y1; ++y) {
+    sampler.beginRow(y);
+    const uint32_t row = (uint32_t)y * kMatrixWidth;
+    uint16_t *out = buffer + row;
+    const uint16_t *frozen = post.frozen ? post.frozen + row : nullptr;
+    uint16_t overlay_x0 = 0;
+    uint16_t overlay_x1 = 0;
+    if (post.overlay) {
+      post.overlay->span(y, overlay_x0, overlay_x1);
+    }
+
+    for (uint16_t x = 0; x < kMatrixWidth; ++x) {
+      uint16_t color = sampler.sample(x);
+      if (frozen) {
+        color = Crossfade::blend565(frozen[x], color, post.alpha5);
+      }
+      if (x >= overlay_x0 && x < overlay_x1) {
+        color = post.overlay->blend(color, row + x);
+      }
+      level_sum += (uint32_t)(color >> (11 + kRedShift)) +
+                   ((color >> (5 + kGreenShift)) & kMaxLevel) +
+                   ((color & 0x1F) >> kBlueShift);
+      if (post.scale < 256) {
+        // Unpack 565
+        uint32_t r = (color >> 11) & 0x1F;
+        uint32_t g = (color >> 5) & 0x3F;
+        uint32_t b = color & 0x1F;
+
+        // Scale
+        r = (r * post.scale) >> 8;
+        g = (g * post.scale) >> 8;
+        b = (b * post.scale) >> 8;
+
+        // Repack
+        color = (uint16_t)((r << 11) | (g << 5) | b);
+      }
+      out[x] = color;
+    }
+  }
+  return level_sum;
 }
@@ -3,19 +3,70 @@
 #include <Arduino.h>
 #include <Adafruit_Protomatter.h>
 
+#include "Crossfade.h"
+#include "RenderTarget.h"
 #include "Scene.h"
+#include "WeatherOverlay.h"
 
 class Engine {
 public:
+  struct Stats {
+    uint32_t frames;
+    uint32_t limited_frames;  // frames drawn with the current limiter active
+    uint32_t post_frames;     // frames that ran the post pass (and were measured)
+    uint16_t demand_ma;       // estimated draw of the last measured frame before limiting
+    uint16_t estimated_ma;    // estimated draw of the last measured frame as shown
+    uint8_t limiter_pct;      // global scale applied by the limiter
+  };
+
   Engine(Adafruit_Protomatter &matrix, uint32_t frame_interval_ms);
 
   void setScene(Scene *scene);
+  void setCrossfade(Crossfade *crossfade);
+  // Composited over every scene in the post pass; null for none.
+  void setOverlay(WeatherOverlay *overlay);
+  void setFrameInterval(uint32_t frame_interval_ms);
   void begin();
   void tick(uint32_t now_ms, float dimmer = 1.0f);
+  // Milliseconds until the next frame is due; 0 when it is due now.
+  uint32_t idleMs(uint32_t now_ms) const;
+
+  const Stats &stats() const { return stats_; }
 
 private:
+  struct PostParams {
+    const uint16_t *frozen; // crossfade snapshot, or null
+    uint8_t alpha5;
+    uint16_t scale;         // 0-256
+    uint16_t dimmer_q8;
+    const WeatherOverlay *overlay; // null when nothing to blend
+  };
+
+  bool limiterNeedsPass();
+  void updateLimiter(uint32_t level_sum, uint16_t dimmer_q8);
+
+  bool prepareTarget(const RenderSpec &spec, RenderTarget &target);
+  void renderStrips(const RenderSpec &spec, float dimmer);
+  void resolve(const RenderTarget &target, Upscale upscale, float dimmer);
+  bool beginResolve(bool direct, float dimmer, PostParams &post);
+  uint32_t resolveRows(const RenderTarget &target, Upscale upscale, const PostParams &post,
+                       uint16_t y0, uint16_t y1);
+  void finishResolve(uint32_t level_sum, const PostParams &post);
+  template <typename Sampler>
+  uint32_t resolveWith(Sampler &sampler, const PostParams &post, uint16_t y0, uint16_t y1);
+
   Adafruit_Protomatter &matrix_;
   Scene *scene_;
+  Crossfade *crossfade_;
+  WeatherOverlay *overlay_;
   uint32_t frame_interval_ms_;
   uint32_t last_frame_ms_;
+  bool warned_spec_;
+  uint16_t limiter_q8_;
+  uint8_t unmeasured_frames_;
+  Stats stats_;
+
+  // Low-resolution scene targets (or one strip of them with APP_STRIP_ROWS)
+  // live here; uint16_t for 565 alignment.
+  uint16_t scratch_[(kRenderScratchBytes + 1) / 2];
 };
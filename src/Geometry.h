@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "BoardConfig.h"
+
+namespace GeometryDetail {
+constexpr uint8_t log2Floor(uint32_t v) {
+  return v <= 1 ? 0 : (uint8_t)(1 + log2Floor(v >> 1));
+}
+} // namespace GeometryDetail
+
+// Compile-time pixel grid. Scenes are templates on a Geometry so buffer
+// sizes, row strides and wrap-around fold to constants; power-of-two sides
+// turn `%` into masks and row multiplies into shifts.
+template <uint16_t W, uint16_t H>
+struct Geometry {
+  static_assert(W > 0 && H > 0, "Geometry must not be empty");
+
+  static constexpr uint16_t kWidth = W;
+  static constexpr uint16_t kHeight = H;
+  static constexpr uint32_t kPixels = (uint32_t)W * H;
+  static constexpr bool kWidthPow2 = (W & (W - 1)) == 0;
+  static constexpr bool kHeightPow2 = (H & (H - 1)) == 0;
+  static constexpr uint8_t kWidthShift = GeometryDetail::log2Floor(W);
+
+  static constexpr int index(int x, int y) {
+    return kWidthPow2 ? (y << kWidthShift) + x : y * W + x;
+  }
+
+  // Wraps a coordinate that is at most one width/height out of range, as
+  // neighbour lookups produce.
+  static constexpr int wrapX(int x) {
+    return kWidthPow2 ? (x & (W - 1)) : (x < 0 ? x + W : (x >= W ? x - W : x));
+  }
+  static constexpr int wrapY(int y) {
+    return kHeightPow2 ? (y & (H - 1)) : (y < 0 ? y + H : (y >= H ? y - H : y));
+  }
+
+  // Reduces any unsigned value (a random number, a cursor) into range.
+  static constexpr uint32_t modX(uint32_t v) {
+    return kWidthPow2 ? (v & (W - 1)) : v % W;
+  }
+  static constexpr uint32_t modY(uint32_t v) {
+    return kHeightPow2 ? (v & (H - 1)) : v % H;
+  }
+};
+
+// The panel (or chain of panels) this build drives.
+using PanelGeometry = Geometry<kMatrixWidth, kMatrixHeight>;
+
+// A grid at `Pct` percent of `G`, for scenes that render below panel size.
+template <typename G, unsigned Pct>
+using ScaledGeometry = Geometry<(uint16_t)(G::kWidth * Pct / 100), (uint16_t)(G::kHeight * Pct / 100)>;
+
+// Cell storage for G with a one-cell toroidal halo: each row carries copies
+// of its wrap-around neighbours, and rows -1 and H copies of rows H-1 and 0.
+// Stencils over interior cells then read x-1..x+1, y-1..y+1 directly, with
+// no wrapping. refresh() rebuilds the halo from the interior.
+template <typename G>
+struct HaloGeometry {
+  static constexpr int kStride = G::kWidth + 2;
+  static constexpr int kRows = G::kHeight + 2;
+  static constexpr uint32_t kCells = (uint32_t)kStride * kRows;
+
+  // Accepts x in [-1, W] and y in [-1, H].
+  static constexpr int index(int x, int y) { return (y + 1) * kStride + x + 1; }
+
+  template <typename T>
+  static void refresh(T *cells) {
+    for (int y = 0; y < G::kHeight; ++y) {
+      T *row = cells + index(0, y);
+      row[-1] = row[G::kWidth - 1];
+      row[G::kWidth] = row[0];
+    }
+    // Whole padded rows, so the corners come along.
+    memcpy(cells + index(-1, -1), cells + index(-1, G::kHeight - 1), kStride * sizeof(T));
+    memcpy(cells + index(-1, G::kHeight), cells + index(-1, 0), kStride * sizeof(T));
+  }
+};
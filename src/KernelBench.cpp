@@ -0,0 +1,218 @@
+#include "KernelBench.h"
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "Geometry.h"
+#include "Noise.h"
+#include "Perf.h"
+#include "Shader.h"
+#include "scenes/RdImplicit.h"
+#include "scenes/RdKernels.h"
+
+namespace KernelBench {
+namespace {
+constexpr uint16_t kFrames = 30;
+constexpr uint32_t kFrameDtMs = 33;
+
+#if APP_KERNEL_BENCH
+uint16_t scratch_[(kFrameScratchBytes + 1) / 2];
+
+using RdBenchGrid = Geometry<32, 16>;
+using RdBenchHalo = HaloGeometry<RdBenchGrid>;
+constexpr uint16_t kRdSteps = 100;
+constexpr uint16_t kRdExplicitStepsPerUpdate = 20;
+float rd_float_[2][RdBenchHalo::kCells];
+int16_t rd_q14_[2][RdBenchHalo::kCells];
+RdKernels::RowRing<RdBenchGrid, float> rd_float_ring_;
+RdKernels::RowRing<RdBenchGrid, int16_t> rd_q14_ring_;
+// Every tile every step, so the kernels compare like for like.
+RdKernels::Tiles<RdBenchGrid, float> rd_float_tiles_(0.0f, 1);
+RdKernels::Tiles<RdBenchGrid, int16_t> rd_q14_tiles_(0, 1);
+RdImplicit::Scratch<RdBenchGrid> rd_implicit_scratch_;
+
+// Same seeded field in both formats: u = 1 with a block of v in the middle.
+template <typename Cells>
+void seedRd(typename Cells::Cell (&grids)[2][RdBenchHalo::kCells]) {
+  for (uint32_t i = 0; i < RdBenchHalo::kCells; ++i) {
+    grids[0][i] = Cells::fromFloat(1.0f);
+    grids[1][i] = Cells::fromFloat(0.0f);
+  }
+  for (int y = 5; y < 11; ++y) {
+    for (int x = 12; x < 20; ++x) {
+      grids[0][RdBenchHalo::index(x, y)] = Cells::fromFloat(0.5f);
+      grids[1][RdBenchHalo::index(x, y)] = Cells::fromFloat(0.25f + 0.05f * (x & 3));
+    }
+  }
+}
+
+template <typename Cell>
+using RdStepFn = void (*)(const RdKernels::StepParams &, Cell *, Cell *,
+                          RdKernels::RowRing<RdBenchGrid, Cell> &,
+                          RdKernels::Tiles<RdBenchGrid, Cell> &);
+
+// Same shape as the explicit kernels; the ring goes unused.
+void stepRdImplicit(const RdKernels::StepParams &p, float *u, float *v,
+                    RdKernels::RowRing<RdBenchGrid, float> &, RdKernels::Tiles<RdBenchGrid, float> &tiles) {
+  RdImplicit::step(p, u, v, rd_implicit_scratch_, tiles, RdKernels::NoEmit());
+}
+
+// Steps as ReactionDiffusionScene does: `steps_per_update` steps per
+// kFrameDtMs of simulated time, each of dt 0.5 * 20 / steps_per_update. The
+// per-cell figures compare kernels; us/sim-s (microseconds per simulated
+// second) compares integrators taking different numbers of steps.
+template <typename Cell>
+void timeRdKernel(const char *name, Cell (&grids)[2][RdBenchHalo::kCells],
+                  RdKernels::RowRing<RdBenchGrid, Cell> &ring,
+                  RdKernels::Tiles<RdBenchGrid, Cell> &tiles, RdStepFn<Cell> step,
+                  uint16_t steps_per_update) {
+  const float dt = 0.5f * (float)kRdExplicitStepsPerUpdate / (float)steps_per_update;
+  const RdKernels::StepParams params{0.037f, 0.060f, 1.0f, 0.5f, dt, 0.1f, 0.05f};
+  const uint32_t t0 = Perf::cycles();
+  const uint32_t start_us = micros();
+  for (uint16_t i = 0; i < kRdSteps; ++i) {
+    step(params, grids[0], grids[1], ring, tiles);
+  }
+  const uint32_t elapsed_us = micros() - start_us;
+  const uint32_t cycles = Perf::cycles() - t0;
+  const uint32_t cells = (uint32_t)kRdSteps * RdBenchGrid::kPixels;
+  const uint64_t sim_us = (uint64_t)elapsed_us * steps_per_update * 1000UL / ((uint32_t)kRdSteps * kFrameDtMs);
+
+  Serial.print("Bench: rd-step ");
+  Serial.print(name);
+  Serial.print(" dt=");
+  Serial.print(dt);
+  Serial.print(" cells/s=");
+  Serial.print(elapsed_us ? (uint32_t)((uint64_t)cells * 1000000UL / elapsed_us) : 0);
+  Serial.print(" cyc/cell=");
+  Serial.print(cycles / cells);
+  Serial.print(" us/sim-s=");
+  Serial.println((uint32_t)sim_us);
+}
+
+constexpr uint32_t kNoiseSamples = 4096;
+
+void printNoise(const char *name, uint32_t cycles, int32_t sink) {
+  Serial.print("Bench: noise ");
+  Serial.print(name);
+  Serial.print(" cyc/sample=");
+  Serial.print(cycles / kNoiseSamples);
+  // Printed so the samples are not optimised away.
+  Serial.print(" sum=");
+  Serial.println(sink);
+}
+#endif
+} // namespace
+
+void printHeader() {
+  Perf::startCycleCounter();
+  Serial.print("Bench: placement=");
+  Serial.print(HOT_KERNEL_PLACEMENT);
+  Serial.print(" cache=");
+  Serial.print(Perf::cacheEnabled() ? "on" : "off");
+  Serial.print(" relocate=");
+  Serial.print(Perf::relocatedBytes());
+  Serial.print("B panel=");
+  Serial.print(kMatrixWidth);
+  Serial.print("x");
+  Serial.println(kMatrixHeight);
+}
+
+void runScene(const char *name, Scene &scene, Adafruit_Protomatter &matrix) {
+#if APP_KERNEL_BENCH
+  const RenderSpec spec = scene.renderSpec();
+  RenderTarget target{};
+  target.width = spec.width;
+  target.height = spec.height;
+  target.format = spec.format;
+  if (spec.isPanel()) {
+    target.rgb = matrix.getBuffer();
+  } else if (spec.format == PixelFormat::kRgb565) {
+    target.rgb = scratch_;
+  } else {
+    target.index = reinterpret_cast<uint8_t *>(scratch_);
+  }
+
+  uint32_t update_cycles = 0;
+  uint32_t render_cycles = 0;
+  const uint32_t start_us = micros();
+  for (uint16_t i = 0; i < kFrames; ++i) {
+    uint32_t t0 = Perf::cycles();
+    scene.update(kFrameDtMs);
+    uint32_t t1 = Perf::cycles();
+    scene.render(target);
+    uint32_t t2 = Perf::cycles();
+    update_cycles += t1 - t0;
+    render_cycles += t2 - t1;
+  }
+  const uint32_t elapsed_us = micros() - start_us;
+  const uint32_t pixels = (uint32_t)spec.width * spec.height;
+
+  Serial.print("Bench: ");
+  Serial.print(name);
+  Serial.print(" ");
+  Serial.print(spec.width);
+  Serial.print("x");
+  Serial.print(spec.height);
+  Serial.print(" update=");
+  Serial.print(update_cycles / kFrames);
+  Serial.print("cyc render=");
+  Serial.print(render_cycles / kFrames);
+  // Per-pixel costs compare directly across the panel geometry envs.
+  Serial.print("cyc update/px=");
+  Serial.print(update_cycles / kFrames / pixels);
+  Serial.print(" render/px=");
+  Serial.print(render_cycles / kFrames / pixels);
+  Serial.print(" frame=");
+  Serial.print(elapsed_us / kFrames);
+  Serial.println("us");
+#else
+  (void)name;
+  (void)scene;
+  (void)matrix;
+#endif
+}
+
+void runRdKernels() {
+#if APP_KERNEL_BENCH
+  seedRd<RdFloatCells>(rd_float_);
+  timeRdKernel("float", rd_float_, rd_float_ring_, rd_float_tiles_, RdKernels::stepGrid<RdBenchGrid>,
+               kRdExplicitStepsPerUpdate);
+  seedRd<RdFloatCells>(rd_float_);
+  timeRdKernel("float-implicit", rd_float_, rd_float_ring_, rd_float_tiles_, stepRdImplicit,
+               APP_RD_IMPLICIT_STEPS);
+  seedRd<RdQ14Cells>(rd_q14_);
+  timeRdKernel("q14", rd_q14_, rd_q14_ring_, rd_q14_tiles_, RdKernels::stepGrid<RdBenchGrid>,
+               kRdExplicitStepsPerUpdate);
+  seedRd<RdQ14Cells>(rd_q14_);
+  timeRdKernel("q14-dsp", rd_q14_, rd_q14_ring_, rd_q14_tiles_, RdKernels::stepGridDsp<RdBenchGrid>,
+               kRdExplicitStepsPerUpdate);
+#endif
+}
+
+void runNoiseKernels() {
+#if APP_KERNEL_BENCH
+  // A 64-pixel row at the default Curl scale, repeated down the rows.
+  constexpr float kScale = 0.08f;
+  const int32_t scale_q16 = Shader::FixedCoords::fromFloat(kScale);
+  const int32_t z_q16 = Shader::FixedCoords::fromFloat(12.5f);
+
+  float sum = 0.0f;
+  uint32_t t0 = Perf::cycles();
+  for (uint32_t i = 0; i < kNoiseSamples; ++i) {
+    const Noise::Gradient g = Noise::perlinGradient((float)(i & 63) * kScale, (float)(i >> 6) * kScale, 12.5f);
+    sum += g.dx + g.dy;
+  }
+  printNoise("float", Perf::cycles() - t0, (int32_t)(sum * 65536.0f));
+
+  int32_t sum_q16 = 0;
+  t0 = Perf::cycles();
+  for (uint32_t i = 0; i < kNoiseSamples; ++i) {
+    const Noise::GradientQ16 g =
+        Noise::perlinGradientQ16((int32_t)(i & 63) * scale_q16, (int32_t)(i >> 6) * scale_q16, z_q16);
+    sum_q16 += g.dx + g.dy;
+  }
+  printNoise("q16", Perf::cycles() - t0, sum_q16);
+#endif
+}
+
+} // namespace KernelBench
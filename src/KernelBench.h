@@ -0,0 +1,23 @@
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_Protomatter.h>
+
+#include "Scene.h"
+
+// Boot-time scene benchmarks for perf builds. Each scene is run for a fixed
+// number of frames and the cycles spent in update() and render() are
+// printed with the HOT_KERNEL placement, so flash and RAM builds can be
+// compared directly.
+namespace KernelBench {
+
+void printHeader();
+void runScene(const char *name, Scene &scene, Adafruit_Protomatter &matrix);
+// Reaction-diffusion step kernels (float, Q1.14, Q1.14 DSP) on one small
+// grid, in cells per second.
+void runRdKernels();
+// Gradient noise as the Curl shader samples it (float, Q16.16), in cycles
+// per sample.
+void runNoiseKernels();
+
+} // namespace KernelBench
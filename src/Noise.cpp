@@ -0,0 +1,294 @@
+#include "Noise.h"
+
+#include <math.h>
+
+#include "Perf.h"
+
+namespace Noise {
+namespace {
+// Ken Perlin's permutation, doubled so that lookups of a lattice
+// coordinate plus one (up to 511) need no wrap.
+const uint8_t p[512] = {
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+    140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+    247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+    57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+    60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+    65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+    200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+    52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+    207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+    119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+    129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+    81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+    184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+    222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+    151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+    140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+    247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+    57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+    74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+    60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+    65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+    200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+    52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+    207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+    119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+    129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+    81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+    184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+    222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+};
+
+// The 12 edge directions of improved noise, padded to 16: a corner with
+// hash h contributes the dot product of kGrad[h & 15] with the offset from
+// it.
+const int8_t kGrad[16][3] = {
+    {1, 1, 0},  {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0}, {1, 0, 1},  {-1, 0, 1},
+    {1, 0, -1}, {-1, 0, -1}, {0, 1, 1}, {0, -1, 1},  {0, 1, -1}, {0, -1, -1},
+    {1, 1, 0},  {0, -1, 1}, {-1, 1, 0}, {0, -1, -1}};
+
+float lerp(float t, float a, float b) {
+  return a + t * (b - a);
+}
+
+float fade(float t) {
+  return t * t * t * (t * (t * 6 - 15) + 10);
+}
+
+float fadeSlope(float t) {
+  const float s = t * (t - 1);
+  return 30 * s * s;
+}
+
+// fade(i / 256) and its slope in Q16, for i = 0..256.
+const int32_t kFadeQ16[257] = {
+    0, 0, 0, 1, 2, 5, 8, 13, 19, 27, 37, 49,
+    63, 79, 99, 121, 145, 173, 204, 239, 277, 319, 364, 414,
+    467, 524, 586, 652, 723, 798, 878, 963, 1052, 1146, 1246, 1350,
+    1460, 1574, 1695, 1820, 1951, 2087, 2229, 2376, 2529, 2687, 2851, 3021,
+    3196, 3377, 3564, 3757, 3955, 4159, 4369, 4585, 4806, 5033, 5266, 5505,
+    5749, 5999, 6255, 6517, 6784, 7057, 7335, 7619, 7909, 8204, 8504, 8810,
+    9121, 9438, 9759, 10086, 10418, 10755, 11098, 11445, 11797, 12154, 12515, 12882,
+    13253, 13628, 14008, 14393, 14781, 15174, 15571, 15973, 16378, 16787, 17199, 17616,
+    18036, 18460, 18887, 19317, 19751, 20187, 20627, 21070, 21515, 21963, 22414, 22867,
+    23323, 23781, 24241, 24703, 25168, 25634, 26101, 26571, 27042, 27514, 27987, 28462,
+    28938, 29415, 29892, 30370, 30849, 31329, 31808, 32288, 32768, 33248, 33728, 34207,
+    34687, 35166, 35644, 36121, 36598, 37074, 37549, 38022, 38494, 38965, 39435, 39902,
+    40368, 40833, 41295, 41755, 42213, 42669, 43122, 43573, 44021, 44466, 44909, 45349,
+    45785, 46219, 46649, 47076, 47500, 47920, 48337, 48749, 49158, 49563, 49965, 50362,
+    50755, 51143, 51528, 51908, 52283, 52654, 53021, 53382, 53739, 54091, 54438, 54781,
+    55118, 55450, 55777, 56098, 56415, 56726, 57032, 57332, 57627, 57917, 58201, 58479,
+    58752, 59019, 59281, 59537, 59787, 60031, 60270, 60503, 60730, 60951, 61167, 61377,
+    61581, 61779, 61972, 62159, 62340, 62515, 62685, 62849, 63007, 63160, 63307, 63449,
+    63585, 63716, 63841, 63962, 64076, 64186, 64290, 64390, 64484, 64573, 64658, 64738,
+    64813, 64884, 64950, 65012, 65069, 65122, 65172, 65217, 65259, 65297, 65332, 65363,
+    65391, 65415, 65437, 65457, 65473, 65487, 65499, 65509, 65517, 65523, 65528, 65531,
+    65534, 65535, 65536, 65536, 65536,
+};
+const int32_t kFadeSlopeQ16[257] = {
+    0, 30, 118, 264, 465, 721, 1030, 1391, 1802, 2262, 2770, 3325,
+    3924, 4568, 5254, 5982, 6750, 7557, 8401, 9282, 10198, 11148, 12132, 13146,
+    14192, 15267, 16370, 17500, 18656, 19838, 21043, 22270, 23520, 24790, 26080, 27388,
+    28714, 30056, 31414, 32786, 34172, 35570, 36980, 38401, 39831, 41270, 42716, 44170,
+    45630, 47095, 48564, 50037, 51512, 52989, 54467, 55945, 57422, 58898, 60371, 61841,
+    63308, 64769, 66226, 67676, 69120, 70556, 71984, 73403, 74813, 76212, 77600, 78977,
+    80342, 81694, 83032, 84357, 85667, 86962, 88241, 89504, 90750, 91979, 93190, 94382,
+    95556, 96710, 97844, 98959, 100052, 101124, 102174, 103203, 104209, 105192, 106152, 107088,
+    108000, 108888, 109751, 110589, 111401, 112188, 112949, 113684, 114392, 115073, 115727, 116354,
+    116953, 117525, 118068, 118583, 119070, 119528, 119958, 120358, 120729, 121072, 121385, 121668,
+    121922, 122146, 122341, 122505, 122640, 122745, 122820, 122865, 122880, 122865, 122820, 122745,
+    122640, 122505, 122341, 122146, 121922, 121668, 121385, 121072, 120729, 120358, 119958, 119528,
+    119070, 118583, 118068, 117525, 116953, 116354, 115727, 115073, 114392, 113684, 112949, 112188,
+    111401, 110589, 109751, 108888, 108000, 107088, 106152, 105192, 104209, 103203, 102174, 101124,
+    100052, 98959, 97844, 96710, 95556, 94382, 93190, 91979, 90750, 89504, 88241, 86962,
+    85667, 84357, 83032, 81694, 80342, 78977, 77600, 76212, 74813, 73403, 71984, 70556,
+    69120, 67676, 66226, 64769, 63308, 61841, 60371, 58898, 57422, 55945, 54467, 52989,
+    51512, 50037, 48564, 47095, 45630, 44170, 42716, 41270, 39831, 38401, 36980, 35570,
+    34172, 32786, 31414, 30056, 28714, 27388, 26080, 24790, 23520, 22270, 21043, 19838,
+    18656, 17500, 16370, 15267, 14192, 13146, 12132, 11148, 10198, 9282, 8401, 7557,
+    6750, 5982, 5254, 4568, 3924, 3325, 2770, 2262, 1802, 1391, 1030, 721,
+    465, 264, 118, 30, 0,
+};
+
+constexpr int32_t kOneQ16 = 65536;
+
+int32_t mulQ16(int32_t a, int32_t b) {
+  return (int32_t)(((int64_t)a * b) >> 16);
+}
+
+int32_t lerpQ16(int32_t t, int32_t a, int32_t b) {
+  return a + mulQ16(t, b - a);
+}
+
+// Table lookup of a Q16 fraction, interpolating between entries.
+int32_t lookupQ16(const int32_t *table, int32_t t) {
+  const int32_t i = t >> 8;
+  return table[i] + (((table[i + 1] - table[i]) * (t & 0xFF)) >> 8);
+}
+
+// Lattice hashes of the cube around a point, shared by the Q16 functions.
+struct Cell {
+  int32_t fx;
+  int32_t fy;
+  int32_t fz;
+  const int8_t *g[2][2][2]; // Corner gradients as [dz][dy][dx]
+  int32_t n[2][2][2];       // Gradient . offset, Q16
+};
+
+HOT_KERNEL void locate(int32_t x, int32_t y, int32_t z, Cell &c) {
+  const int X = (x >> 16) & 255;
+  const int Y = (y >> 16) & 255;
+  const int Z = (z >> 16) & 255;
+  c.fx = x & 0xFFFF;
+  c.fy = y & 0xFFFF;
+  c.fz = z & 0xFFFF;
+
+  const int A = p[X] + Y, AA = p[A] + Z, AB = p[A + 1] + Z;
+  const int B = p[X + 1] + Y, BA = p[B] + Z, BB = p[B + 1] + Z;
+  const int hashes[2][2][2] = {{{p[AA], p[BA]}, {p[AB], p[BB]}},
+                               {{p[AA + 1], p[BA + 1]}, {p[AB + 1], p[BB + 1]}}};
+  for (int k = 0; k < 2; ++k) {
+    for (int j = 0; j < 2; ++j) {
+      for (int i = 0; i < 2; ++i) {
+        const int8_t *g = kGrad[hashes[k][j][i] & 15];
+        c.g[k][j][i] = g;
+        c.n[k][j][i] = g[0] * (c.fx - i * kOneQ16) + g[1] * (c.fy - j * kOneQ16) +
+                       g[2] * (c.fz - k * kOneQ16);
+      }
+    }
+  }
+}
+} // namespace
+
+// The noise is a trilinear blend, by the faded offsets, of each corner's
+// gradient dotted with the offset from it. Its x derivative is the same
+// blend of the gradients' x components plus the blend's own slope along
+// x times the fade's; likewise for y.
+HOT_KERNEL Gradient perlinGradient(float x, float y, float z) {
+  const float fx = floorf(x);
+  const float fy = floorf(y);
+  const float fz = floorf(z);
+  const int X = (int)fx & 255;
+  const int Y = (int)fy & 255;
+  const int Z = (int)fz & 255;
+  x -= fx;
+  y -= fy;
+  z -= fz;
+
+  const float u = fade(x);
+  const float v = fade(y);
+  const float w = fade(z);
+
+  const int A = p[X] + Y, AA = p[A] + Z, AB = p[A + 1] + Z;
+  const int B = p[X + 1] + Y, BA = p[B] + Z, BB = p[B + 1] + Z;
+
+  // Corners as [dz][dy][dx].
+  const int8_t *g[2][2][2] = {
+      {{kGrad[p[AA] & 15], kGrad[p[BA] & 15]}, {kGrad[p[AB] & 15], kGrad[p[BB] & 15]}},
+      {{kGrad[p[AA + 1] & 15], kGrad[p[BA + 1] & 15]}, {kGrad[p[AB + 1] & 15], kGrad[p[BB + 1] & 15]}}};
+  float n[2][2][2];
+  for (int k = 0; k < 2; ++k) {
+    for (int j = 0; j < 2; ++j) {
+      for (int i = 0; i < 2; ++i) {
+        const int8_t *c = g[k][j][i];
+        n[k][j][i] = c[0] * (x - i) + c[1] * (y - j) + c[2] * (z - k);
+      }
+    }
+  }
+
+  const float x00 = lerp(u, n[0][0][0], n[0][0][1]);
+  const float x10 = lerp(u, n[0][1][0], n[0][1][1]);
+  const float x01 = lerp(u, n[1][0][0], n[1][0][1]);
+  const float x11 = lerp(u, n[1][1][0], n[1][1][1]);
+  const float value = lerp(w, lerp(v, x00, x10), lerp(v, x01, x11));
+
+  const float slope_u = lerp(w, lerp(v, n[0][0][1] - n[0][0][0], n[0][1][1] - n[0][1][0]),
+                             lerp(v, n[1][0][1] - n[1][0][0], n[1][1][1] - n[1][1][0]));
+  const float slope_v = lerp(w, x10 - x00, x11 - x01);
+
+  float gx[2][2];
+  float gy[2][2];
+  for (int k = 0; k < 2; ++k) {
+    for (int j = 0; j < 2; ++j) {
+      gx[k][j] = lerp(u, g[k][j][0][0], g[k][j][1][0]);
+      gy[k][j] = lerp(u, g[k][j][0][1], g[k][j][1][1]);
+    }
+  }
+  const float dx = lerp(w, lerp(v, gx[0][0], gx[0][1]), lerp(v, gx[1][0], gx[1][1])) +
+                   slope_u * fadeSlope(x);
+  const float dy = lerp(w, lerp(v, gy[0][0], gy[0][1]), lerp(v, gy[1][0], gy[1][1])) +
+                   slope_v * fadeSlope(y);
+
+  return Gradient{0.5f * value, 0.5f * dx, 0.5f * dy};
+}
+
+// As perlinGradient(); gradient components are whole units, so their
+// blends start from +-1 or 0 in Q16.
+HOT_KERNEL GradientQ16 perlinGradientQ16(int32_t x, int32_t y, int32_t z) {
+  Cell c;
+  locate(x, y, z, c);
+  const int32_t u = lookupQ16(kFadeQ16, c.fx);
+  const int32_t v = lookupQ16(kFadeQ16, c.fy);
+  const int32_t w = lookupQ16(kFadeQ16, c.fz);
+
+  const int32_t x00 = lerpQ16(u, c.n[0][0][0], c.n[0][0][1]);
+  const int32_t x10 = lerpQ16(u, c.n[0][1][0], c.n[0][1][1]);
+  const int32_t x01 = lerpQ16(u, c.n[1][0][0], c.n[1][0][1]);
+  const int32_t x11 = lerpQ16(u, c.n[1][1][0], c.n[1][1][1]);
+  const int32_t value = lerpQ16(w, lerpQ16(v, x00, x10), lerpQ16(v, x01, x11));
+
+  const int32_t slope_u =
+      lerpQ16(w, lerpQ16(v, c.n[0][0][1] - c.n[0][0][0], c.n[0][1][1] - c.n[0][1][0]),
+              lerpQ16(v, c.n[1][0][1] - c.n[1][0][0], c.n[1][1][1] - c.n[1][1][0]));
+  const int32_t slope_v = lerpQ16(w, x10 - x00, x11 - x01);
+
+  int32_t gx[2][2];
+  int32_t gy[2][2];
+  for (int k = 0; k < 2; ++k) {
+    for (int j = 0; j < 2; ++j) {
+      gx[k][j] = lerpQ16(u, c.g[k][j][0][0] * kOneQ16, c.g[k][j][1][0] * kOneQ16);
+      gy[k][j] = lerpQ16(u, c.g[k][j][0][1] * kOneQ16, c.g[k][j][1][1] * kOneQ16);
+    }
+  }
+  const int32_t dx = lerpQ16(w, lerpQ16(v, gx[0][0], gx[0][1]), lerpQ16(v, gx[1][0], gx[1][1])) +
+                     mulQ16(slope_u, lookupQ16(kFadeSlopeQ16, c.fx));
+  const int32_t dy = lerpQ16(w, lerpQ16(v, gy[0][0], gy[0][1]), lerpQ16(v, gy[1][0], gy[1][1])) +
+                     mulQ16(slope_v, lookupQ16(kFadeSlopeQ16, c.fy));
+
+  return GradientQ16{value >> 1, dx >> 1, dy >> 1};
+}
+
+// Folds (x, y) into the first quadrant by half and quarter turns, then
+// places it against tan(22.5), 1 and tan(67.5) by cross-multiplying.
+uint8_t sector16(int32_t x, int32_t y) {
+  constexpr int64_t kTan22_5 = 27146; // Q16
+  uint8_t sector = 0;
+  if (y < 0 || (y == 0 && x < 0)) {
+    x = -x;
+    y = -y;
+    sector = 8;
+  }
+  if (x <= 0) {
+    const int32_t t = x;
+    x = y;
+    y = -t;
+    sector += 4;
+  }
+  // Now 0 <= angle < 90 degrees.
+  if (((int64_t)y << 16) < (int64_t)x * kTan22_5) {
+    return sector;
+  }
+  if (y < x) {
+    return sector + 1;
+  }
+  if ((int64_t)y * kTan22_5 < ((int64_t)x << 16)) {
+    return sector + 2;
+  }
+  return sector + 3;
+}
+
+} // namespace Noise
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+
+// 3D gradient (Perlin) noise shared by the noise-driven scenes. Values are
+// in about [-0.5, 0.5]; the lattice repeats every 256 units.
+namespace Noise {
+
+struct Gradient {
+  float value;
+  float dx; // d value / dx
+  float dy; // d value / dy
+};
+
+// Noise at (x, y, z) with its x and y derivatives, worked out analytically
+// in the same evaluation instead of by differencing further samples.
+Gradient perlinGradient(float x, float y, float z);
+
+// Fixed-point perlinGradient() for cores without a fast FPU: Q16.16
+// coordinates in, Q16.16 value and derivatives out, integer math
+// throughout. The fades come from a 256-segment table, which keeps results
+// within a few Q16 units of the float function.
+struct GradientQ16 {
+  int32_t value;
+  int32_t dx;
+  int32_t dy;
+};
+
+GradientQ16 perlinGradientQ16(int32_t x, int32_t y, int32_t z);
+
+// Which 22.5 degree sector (x, y) points into, 0-15 counting anticlockwise
+// from +x: floor(atan2(y, x) / 22.5 degrees) over [0, 360), without atan2f.
+uint8_t sector16(int32_t x, int32_t y);
+
+} // namespace Noise
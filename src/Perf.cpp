@@ -0,0 +1,56 @@
+#include "Perf.h"
+
+#if defined(__SAMD51__)
+// Bounds of .relocate (.ramfunc + .data) from the core's linker script.
+extern "C" {
+extern uint32_t _srelocate;
+extern uint32_t _erelocate;
+}
+#endif
+
+namespace Perf {
+
+void enableCache() {
+#if defined(__SAMD51__)
+  if (CMCC->SR.bit.CSTS) {
+    return;
+  }
+  // The cache must be invalidated while disabled.
+  CMCC->MAINT0.reg = CMCC_MAINT0_INVALL;
+  CMCC->CTRL.reg = CMCC_CTRL_CEN;
+#endif
+}
+
+bool cacheEnabled() {
+#if defined(__SAMD51__)
+  return CMCC->SR.bit.CSTS;
+#else
+  return false;
+#endif
+}
+
+void startCycleCounter() {
+#if defined(__SAMD51__)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+uint32_t cycles() {
+#if defined(__SAMD51__)
+  return DWT->CYCCNT;
+#else
+  return 0;
+#endif
+}
+
+uint32_t relocatedBytes() {
+#if defined(__SAMD51__)
+  return (uint32_t)((uintptr_t)&_erelocate - (uintptr_t)&_srelocate);
+#else
+  return 0;
+#endif
+}
+
+} // namespace Perf
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "AppConfig.h"
+
+// HOT_KERNEL marks the inner loops of the scenes. In perf builds with
+// APP_RAM_KERNELS they go to .ramfunc, which the SAMD51 startup code copies
+// into SRAM with .data, so they run without flash wait states. long_call
+// lets flash code reach them (and them reach flash) across the address gap.
+#if APP_PERF_BUILD && APP_RAM_KERNELS && defined(__SAMD51__)
+#define HOT_KERNEL __attribute__((section(".ramfunc"), long_call))
+#define HOT_KERNEL_PLACEMENT "ram"
+#else
+#define HOT_KERNEL
+#define HOT_KERNEL_PLACEMENT "flash"
+#endif
+
+namespace Perf {
+
+// Turns on the Cortex-M4 cache controller (CMCC) if the core left it off.
+void enableCache();
+bool cacheEnabled();
+
+// DWT cycle counter; cycles() returns 0 where it is unavailable.
+void startCycleCounter();
+uint32_t cycles();
+
+// Bytes of SRAM taken by initialised data plus RAM-resident kernels.
+uint32_t relocatedBytes();
+
+} // namespace Perf
@@ -0,0 +1,145 @@
+#include "PowerGovernor.h"
+
+#include <WiFiNINA.h>
+
+#include "AppConfig.h"
+
+namespace {
+constexpr PowerGovernor::Settings kProfiles[] = {
+  // frame_interval_ms, brightness, fetch_interval_ms, radio_sleep
+  {33, 1.00f, 10UL * 60UL * 1000UL, false}, // Day: ~30 FPS
+  {50, 0.70f, 15UL * 60UL * 1000UL, true},  // Evening: ~20 FPS
+  {80, 0.30f, 30UL * 60UL * 1000UL, true},  // Night: ~12 FPS
+};
+
+constexpr uint32_t kClockPollMs = 60000;
+constexpr uint32_t kSecondsPerDay = 86400;
+
+float lerp(float a, float b, float t) {
+  return a + (b - a) * t;
+}
+} // namespace
+
+PowerGovernor::PowerGovernor()
+    : profile_(Profile::kDay),
+      from_(kProfiles[0]),
+      current_(kProfiles[0]),
+      transition_start_ms_(0),
+      transitioning_(false),
+      clock_valid_(false),
+      epoch_base_s_(0),
+      epoch_base_ms_(0),
+      last_clock_poll_ms_(0),
+      radio_sleep_(false) {}
+
+const char *PowerGovernor::profileName(Profile profile) {
+  switch (profile) {
+    case Profile::kDay:
+      return "day";
+    case Profile::kEvening:
+      return "evening";
+    case Profile::kNight:
+      return "night";
+  }
+  return "unknown";
+}
+
+void PowerGovernor::begin(uint32_t now_ms) {
+  profile_ = Profile::kDay;
+  current_ = kProfiles[(uint8_t)profile_];
+  transitioning_ = false;
+  clock_valid_ = false;
+  last_clock_poll_ms_ = now_ms - kClockPollMs;
+  radio_sleep_ = false;
+}
+
+PowerGovernor::Profile PowerGovernor::profileForHour(uint8_t hour) {
+  if (hour >= APP_NIGHT_START_HOUR || hour < APP_DAY_START_HOUR) {
+    return Profile::kNight;
+  }
+  if (hour >= APP_EVENING_START_HOUR) {
+    return Profile::kEvening;
+  }
+  return Profile::kDay;
+}
+
+void PowerGovernor::pollClock(uint32_t now_ms) {
+  last_clock_poll_ms_ = now_ms;
+  // 0 until the NINA firmware has synced with NTP.
+  const uint32_t epoch_s = (uint32_t)WiFi.getTime();
+  if (epoch_s == 0) {
+    return;
+  }
+  if (!clock_valid_) {
+    Serial.print("Governor: clock synced, epoch=");
+    Serial.println(epoch_s);
+  }
+  epoch_base_s_ = epoch_s;
+  epoch_base_ms_ = now_ms;
+  clock_valid_ = true;
+}
+
+void PowerGovernor::applyRadio(bool sleep) {
+  if (sleep == radio_sleep_) {
+    return;
+  }
+  // Modem sleep between DTIM beacons; the radio wakes for fetches.
+  if (sleep) {
+    WiFi.lowPowerMode();
+  } else {
+    WiFi.noLowPowerMode();
+  }
+  radio_sleep_ = sleep;
+}
+
+void PowerGovernor::tick(uint32_t now_ms, bool wifi_connected, int32_t utc_offset_s) {
+#if APP_POWER_GOVERNOR
+  if (wifi_connected && (uint32_t)(now_ms - last_clock_poll_ms_) >= kClockPollMs) {
+    pollClock(now_ms);
+  }
+
+  if (clock_valid_) {
+    const uint32_t utc_s = epoch_base_s_ + (now_ms - epoch_base_ms_) / 1000;
+    const int32_t day_s = (int32_t)((utc_s + (uint32_t)utc_offset_s) % kSecondsPerDay);
+    const Profile next = profileForHour((uint8_t)(day_s / 3600));
+    if (next != profile_) {
+      Serial.print("Governor: profile ");
+      Serial.print(profileName(profile_));
+      Serial.print(" -> ");
+      Serial.println(profileName(next));
+      from_ = current_;
+      profile_ = next;
+      transition_start_ms_ = now_ms;
+      transitioning_ = true;
+    }
+  }
+
+  const Settings &target = kProfiles[(uint8_t)profile_];
+  if (transitioning_) {
+    const uint32_t elapsed = now_ms - transition_start_ms_;
+    const float t = (elapsed >= APP_GOVERNOR_TRANSITION_MS)
+                        ? 1.0f
+                        : (float)elapsed / (float)APP_GOVERNOR_TRANSITION_MS;
+    current_.frame_interval_ms =
+        (uint32_t)(lerp((float)from_.frame_interval_ms, (float)target.frame_interval_ms, t) + 0.5f);
+    current_.brightness = lerp(from_.brightness, target.brightness, t);
+    transitioning_ = t < 1.0f;
+  } else {
+    current_.frame_interval_ms = target.frame_interval_ms;
+    current_.brightness = target.brightness;
+  }
+  current_.fetch_interval_ms = target.fetch_interval_ms;
+  current_.radio_sleep = target.radio_sleep;
+
+  if (wifi_connected) {
+    applyRadio(current_.radio_sleep);
+  } else {
+    // Reapply on the next connection in case the radio was reset.
+    radio_sleep_ = false;
+  }
+#else
+  (void)now_ms;
+  (void)wifi_connected;
+  (void)utc_offset_s;
+#endif
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Switches between day, evening and night power profiles by local time.
+// Wall-clock time comes from the NINA firmware (WiFi.getTime()); until it
+// is known the governor stays in the day profile.
+class PowerGovernor {
+public:
+  enum class Profile : uint8_t {
+    kDay,
+    kEvening,
+    kNight
+  };
+
+  struct Settings {
+    uint32_t frame_interval_ms;
+    float brightness;           // 0.0-1.0, multiplies the fetch dimmer
+    uint32_t fetch_interval_ms;
+    bool radio_sleep;           // NINA low-power mode between fetches
+  };
+
+  PowerGovernor();
+
+  void begin(uint32_t now_ms);
+  // utc_offset_s: local offset in seconds, e.g. from the weather response.
+  void tick(uint32_t now_ms, bool wifi_connected, int32_t utc_offset_s);
+
+  Profile profile() const { return profile_; }
+  const char *profileName() const { return profileName(profile_); }
+  static const char *profileName(Profile profile);
+
+  // Settings eased across the current profile transition.
+  const Settings &current() const { return current_; }
+  bool hasClock() const { return clock_valid_; }
+
+private:
+  static Profile profileForHour(uint8_t hour);
+  void pollClock(uint32_t now_ms);
+  void applyRadio(bool sleep);
+
+  Profile profile_;
+  Settings from_;
+  Settings current_;
+  uint32_t transition_start_ms_;
+  bool transitioning_;
+
+  bool clock_valid_;
+  uint32_t epoch_base_s_;
+  uint32_t epoch_base_ms_;
+  uint32_t last_clock_poll_ms_;
+  bool radio_sleep_;
+};
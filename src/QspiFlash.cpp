@@ -0,0 +1,168 @@
+#include "QspiFlash.h"
+
+#include "AppConfig.h"
+
+namespace QspiFlash {
+namespace {
+constexpr uint32_t kBase = APP_QSPI_SNAPSHOT_OFFSET;
+constexpr uint32_t kSize = APP_QSPI_SNAPSHOT_BYTES;
+static_assert(kBase % kSectorBytes == 0 && kSize % kSectorBytes == 0,
+              "Snapshot region must be whole sectors");
+
+bool ready_ = false;
+bool tried_ = false;
+
+bool inRegion(uint32_t addr, uint32_t len) {
+  return ready_ && addr <= kSize && len <= kSize - addr;
+}
+} // namespace
+
+uint32_t size() {
+  return ready_ ? kSize : 0;
+}
+} // namespace QspiFlash
+
+#if defined(__SAMD51__)
+
+#include <Adafruit_SPIFlash.h>
+
+namespace QspiFlash {
+namespace {
+Adafruit_FlashTransport_QSPI transport_;
+Adafruit_SPIFlash flash_(&transport_);
+
+void waitIdle() {
+  while (busy()) {
+  }
+}
+} // namespace
+
+bool begin() {
+  if (!tried_) {
+    tried_ = true;
+    ready_ = flash_.begin() && flash_.size() >= kBase + kSize;
+    Serial.print("QspiFlash: ");
+    Serial.println(ready_ ? "ready" : "unavailable");
+  }
+  return ready_;
+}
+
+bool busy() {
+  return ready_ && (flash_.readStatus() & 0x01) != 0;
+}
+
+void read(uint32_t addr, void *out, uint32_t len) {
+  if (!inRegion(addr, len)) {
+    return;
+  }
+  waitIdle();
+  flash_.readBuffer(kBase + addr, static_cast<uint8_t *>(out), len);
+}
+
+void startErase(uint32_t addr) {
+  if (!inRegion(addr, 1)) {
+    return;
+  }
+  waitIdle();
+  transport_.runCommand(SFLASH_CMD_WRITE_ENABLE);
+  transport_.eraseCommand(SFLASH_CMD_ERASE_SECTOR, kBase + addr - addr % kSectorBytes);
+}
+
+void startProgram(uint32_t addr, const void *data, uint32_t len) {
+  if (!inRegion(addr, len) || len == 0 || addr % kPageBytes + len > kPageBytes) {
+    return;
+  }
+  waitIdle();
+  transport_.runCommand(SFLASH_CMD_WRITE_ENABLE);
+  transport_.writeMemory(kBase + addr, static_cast<const uint8_t *>(data), len);
+}
+
+} // namespace QspiFlash
+
+#else
+
+#include <stdio.h>
+#include <string.h>
+
+namespace QspiFlash {
+namespace {
+FILE *file_ = nullptr;
+const char *path_ = APP_QSPI_HOST_FILE;
+
+void fillErased(uint32_t addr, uint32_t len) {
+  uint8_t erased[64];
+  memset(erased, 0xFF, sizeof(erased));
+  fseek(file_, (long)addr, SEEK_SET);
+  while (len > 0) {
+    const uint32_t n = len < sizeof(erased) ? len : (uint32_t)sizeof(erased);
+    fwrite(erased, 1, n, file_);
+    len -= n;
+  }
+}
+} // namespace
+
+bool begin() {
+  if (!tried_) {
+    tried_ = true;
+    file_ = fopen(path_, "r+b");
+    if (!file_) {
+      file_ = fopen(path_, "w+b");
+      if (file_) {
+        fillErased(0, kSize);
+      }
+    }
+    ready_ = file_ != nullptr;
+  }
+  return ready_;
+}
+
+bool busy() {
+  return false;
+}
+
+void read(uint32_t addr, void *out, uint32_t len) {
+  if (!inRegion(addr, len)) {
+    return;
+  }
+  // Past the end of a short file reads as erased.
+  memset(out, 0xFF, len);
+  fseek(file_, (long)addr, SEEK_SET);
+  (void)fread(out, 1, len, file_);
+}
+
+void startErase(uint32_t addr) {
+  if (!inRegion(addr, 1)) {
+    return;
+  }
+  fillErased(addr - addr % kSectorBytes, kSectorBytes);
+  fflush(file_);
+}
+
+void startProgram(uint32_t addr, const void *data, uint32_t len) {
+  if (!inRegion(addr, len) || len == 0 || addr % kPageBytes + len > kPageBytes) {
+    return;
+  }
+  uint8_t page[kPageBytes];
+  read(addr, page, len);
+  const uint8_t *bits = static_cast<const uint8_t *>(data);
+  for (uint32_t i = 0; i < len; ++i) {
+    page[i] &= bits[i];
+  }
+  fseek(file_, (long)addr, SEEK_SET);
+  fwrite(page, 1, len, file_);
+  fflush(file_);
+}
+
+void setHostFile(const char *path) {
+  if (file_) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+  path_ = path;
+  tried_ = false;
+  ready_ = false;
+}
+
+} // namespace QspiFlash
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+
+// The snapshot region of the board's QSPI NOR flash (APP_QSPI_SNAPSHOT_*),
+// addressed from the start of the region. Erase and program only start the
+// operation, so a caller can spread a write over frames and poll busy();
+// read() waits for a pending one first. Off target the region is a file
+// with the same erase/program semantics (erased bytes read 0xFF,
+// programming can only clear bits) and nothing is ever busy.
+namespace QspiFlash {
+
+constexpr uint32_t kSectorBytes = 4096;
+// A program must not cross a page boundary.
+constexpr uint32_t kPageBytes = 256;
+
+// False when the chip (or file) is unavailable; the rest then do nothing.
+// Safe to call again.
+bool begin();
+uint32_t size();
+
+bool busy();
+void read(uint32_t addr, void *out, uint32_t len);
+// `addr` is rounded down to its sector.
+void startErase(uint32_t addr);
+void startProgram(uint32_t addr, const void *data, uint32_t len);
+
+#if !defined(__SAMD51__)
+// Backs the region with the file at `path` (APP_QSPI_HOST_FILE until set)
+// from the next begin(), closing any file already open. Each native test
+// binary uses its own, so no test reads another's snapshots.
+void setHostFile(const char *path);
+#endif
+
+} // namespace QspiFlash
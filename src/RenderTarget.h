@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+
+enum class PixelFormat : uint8_t {
+  kRgb565,
+  // One palette index per pixel; the scene points `palette` at its table.
+  kIndexed8
+};
+
+enum class Upscale : uint8_t {
+  kNearest,
+  // Bilinear on kIndexed8 interpolates the index before the palette lookup,
+  // which keeps ramp palettes (RD) on-palette instead of mixing RGB.
+  kBilinear
+};
+
+// Enough for a whole 3/4-scale RGB565 frame or a full-scale indexed frame.
+constexpr size_t kFrameScratchBytes = (size_t)kMatrixWidth * kMatrixHeight * 9 / 8;
+
+#if APP_STRIP_ROWS > 0
+// Source rows behind one strip of panel rows at up to panel resolution,
+// plus the rows either upscaler reads across the strip edges.
+constexpr uint16_t kStripSourceRows = APP_STRIP_ROWS + 3;
+constexpr size_t kRenderScratchBytes = (size_t)kStripSourceRows * kMatrixWidth * 2;
+#else
+// Bytes Engine reserves for scenes that render below panel resolution.
+constexpr size_t kRenderScratchBytes = kFrameScratchBytes;
+#endif
+
+// What a scene wants to render into. Anything other than a panel-sized
+// RGB565 target is rendered into Engine scratch memory and upscaled while
+// Engine writes the final framebuffer.
+struct RenderSpec {
+  uint16_t width;
+  uint16_t height;
+  PixelFormat format;
+  Upscale upscale;
+
+  static constexpr RenderSpec panel() {
+    return RenderSpec{kMatrixWidth, kMatrixHeight, PixelFormat::kRgb565, Upscale::kNearest};
+  }
+
+  constexpr bool isPanel() const {
+    return width == kMatrixWidth && height == kMatrixHeight && format == PixelFormat::kRgb565;
+  }
+
+  constexpr size_t bytes() const {
+    return (size_t)width * height * (format == PixelFormat::kRgb565 ? 2 : 1);
+  }
+
+  // Whole-frame rendering; strip rendering only needs width <= panel.
+  constexpr bool fitsScratch() const {
+    return isPanel() || (width <= kMatrixWidth && height <= kMatrixHeight &&
+                         bytes() <= kRenderScratchBytes);
+  }
+  constexpr bool fitsStrips() const {
+    return width <= kMatrixWidth && height <= kMatrixHeight;
+  }
+};
+
+struct RenderTarget {
+  uint16_t width;
+  uint16_t height;
+  PixelFormat format;
+  uint16_t *rgb;           // kRgb565: width * height pixels, row-major
+  uint8_t *index;          // kIndexed8: width * height palette indices
+  const uint16_t *palette; // kIndexed8: set by the scene while rendering
+  // Strip rendering: the buffers start at this row of the target rather
+  // than row 0. Always 0 for whole frames.
+  uint16_t row0;
+};
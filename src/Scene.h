@@ -3,6 +3,8 @@
 #include <Arduino.h>
 #include <Adafruit_Protomatter.h>
 
+#include "RenderTarget.h"
+
 struct WeatherParams {
   float temp_f;
   float wind_speed_mph;
@@ -13,12 +15,51 @@ struct WeatherParams {
 
 class Scene {
 public:
+  // Longest dt_ms Engine passes to update(); a longer gap between frames is
+  // clamped to it, so a stall slows the scene instead of jumping it ahead.
+  static constexpr uint32_t kMaxUpdateMs = 100;
+
   virtual ~Scene() = default;
   virtual void begin(Adafruit_Protomatter &matrix) {
     (void)matrix;
   }
+  // Resolution and format of the target passed to render(). Engine upscales
+  // anything smaller than the panel.
+  virtual RenderSpec renderSpec() const {
+    return RenderSpec::panel();
+  }
+  // Simulated time a freshly begun scene needs before it looks developed.
+  // SceneManager fast-forwards it through warmup() for that long.
+  virtual uint32_t warmupMs() const {
+    return 0;
+  }
+  // One off-screen step; nothing rendered here is shown.
+  virtual void warmup(uint32_t dt_ms) {
+    update(dt_ms);
+  }
   virtual void update(uint32_t dt_ms) = 0;
-  virtual void render(Adafruit_Protomatter &matrix) = 0;
+  virtual void render(RenderTarget &target) = 0;
+  // update() then render() for whole-frame rendering. Scenes whose last
+  // simulation step already holds every pixel's value override this to
+  // write the target as they go instead of making a second pass.
+  virtual void updateAndRender(uint32_t dt_ms, RenderTarget &target) {
+    update(dt_ms);
+    render(target);
+  }
+  // Scenes whose rows can be produced independently let Engine render a
+  // frame in strips (APP_STRIP_ROWS) through a small reusable buffer. Only
+  // below panel resolution; a panel-size frame goes to the framebuffer
+  // whole.
+  virtual bool supportsRowRange() const {
+    return false;
+  }
+  // Renders target rows [y0, y0 + rows); buffer row 0 is target.row0 (== y0).
+  // Called once per strip after the frame's update().
+  virtual void renderRows(RenderTarget &target, uint16_t y0, uint16_t rows) {
+    (void)target;
+    (void)y0;
+    (void)rows;
+  }
   virtual void setWeather(const WeatherParams &params) {
     (void)params;
   }
@@ -1,11 +1,16 @@
 #include "SceneManager.h"
 
+#include "BufferOps.h"
+#include "KernelBench.h"
+
 // Define the flash storage slot (must be global/file scope)
 FlashStorage(flash_store, SceneManager::PersistentState);
 
 SceneManager::SceneManager(Adafruit_Protomatter &matrix, uint8_t button_pin)
     : matrix_(matrix), button_pin_(button_pin), active_scene_(nullptr),
-      internal_scene_index_(0),
+      active_target_id_(0), internal_scene_index_(0), weather_{},
+      warming_(false), prewarmed_(false), warm_remaining_ms_(0),
+      warm_start_ms_(0), warm_slices_(0), warm_us_per_ms_(0),
       last_button_state_(HIGH), last_debounce_time_(0),
       button_pressed_event_(false) {}
 
@@ -14,6 +19,10 @@ void SceneManager::begin() {
   last_button_state_ = digitalRead(button_pin_);
   
   loadState();
+
+  Serial.print("SceneManager: scene arena ");
+  Serial.print((uint32_t)sizeof(slot_));
+  Serial.println(" bytes");
   
   // Validate loaded ID
   if (state_.current_scene_id >= kSceneCount) {
@@ -61,42 +70,84 @@ void SceneManager::update(uint32_t dt_ms) {
   }
 }
 
-void SceneManager::render() {
+void SceneManager::setWeather(const WeatherParams &params) {
+  // Cached so scenes constructed later start with the current weather.
+  weather_ = params;
   if (active_scene_) {
-    active_scene_->render(matrix_);
+    active_scene_->setWeather(params);
   }
 }
 
-void SceneManager::setWeather(const WeatherParams &params) {
-  // Propagate to all scenes (so they are ready when switched to)
-  flowFieldScene_.setWeather(params);
-  reactionDiffusionScene_.setWeather(params);
-  curlNoiseScene_.setWeather(params);
+void SceneManager::leaveActiveScene() {
+  if (!active_scene_) {
+    return;
+  }
+  if (active_target_id_ == 1) {
+    reaction_diffusion_resume_ = slot_.as<ReactionDiffusionScene>().resume();
+  } else if (active_target_id_ == 2) {
+    curl_noise_resume_ = slot_.as<CurlNoiseScene>().resume();
+  } else {
+    flow_field_resume_ = slot_.as<FlowFieldScene>().resume();
+  }
+  // Nothing may still be streaming out of the scene's buffers.
+  BufferOps::waitAll();
+  slot_.reset();
+  active_scene_ = nullptr;
 }
 
-void SceneManager::switchScene(uint8_t scene_id) {
-  matrix_.fillScreen(0);
+Scene &SceneManager::constructScene(uint8_t target_id) {
+  Scene *scene;
+  if (target_id == 1) {
+    scene = &slot_.emplace<ReactionDiffusionScene>(reaction_diffusion_resume_);
+  } else if (target_id == 2) {
+    scene = &slot_.emplace<CurlNoiseScene>(curl_noise_resume_);
+  } else {
+    scene = &slot_.emplace<FlowFieldScene>(flow_field_resume_);
+  }
+  if (weather_.valid) {
+    scene->setWeather(weather_);
+  }
+  return *scene;
+}
+
+void SceneManager::switchScene(uint8_t scene_id, bool crossfade) {
+  if (active_scene_ && crossfade) {
+    // Freeze the last shown frame; Engine fades it into the new scene.
+    crossfade_.begin(matrix_.getBuffer(), APP_CROSSFADE_MS);
+  } else {
+    crossfade_.cancel();
+    BufferOps::fill16(matrix_.getBuffer(), 0, (size_t)kMatrixWidth * kMatrixHeight);
+  }
   
   uint8_t target_id = scene_id;
   if (scene_id == kCycleModeId) {
     target_id = internal_scene_index_;
   }
 
-  if (target_id == 0) {
-    active_scene_ = &flowFieldScene_;
-  } else if (target_id == 1) {
-    active_scene_ = &reactionDiffusionScene_;
-  } else if (target_id == 2) {
-    active_scene_ = &curlNoiseScene_;
-  } else {
-    active_scene_ = &flowFieldScene_; // Default
+  if (target_id > 2) {
+    target_id = 0; // Default to FlowField
   }
-  
+
+  leaveActiveScene();
+  active_scene_ = &constructScene(target_id);
+  active_target_id_ = target_id;
+
   state_.current_scene_id = scene_id;
   active_scene_->begin(matrix_);
+
+  warm_remaining_ms_ = active_scene_->warmupMs();
+  warming_ = warm_remaining_ms_ > 0;
+  warm_start_ms_ = millis();
+  warm_slices_ = 0;
+  warm_us_per_ms_ = 0;
 }
 
 void SceneManager::cycleSceneIfEnabled() {
+  if (prewarmed_) {
+    // Already switched (and warmed) while the panel was dark.
+    prewarmed_ = false;
+    return;
+  }
   if (state_.current_scene_id == kCycleModeId) {
     internal_scene_index_ = (internal_scene_index_ + 1) % 3; // Cycle through 3 real scenes
     switchScene(kCycleModeId);
@@ -105,6 +156,88 @@ void SceneManager::cycleSceneIfEnabled() {
   }
 }
 
+void SceneManager::prewarmNext() {
+  if (prewarmed_ || state_.current_scene_id != kCycleModeId) {
+    return;
+  }
+  internal_scene_index_ = (internal_scene_index_ + 1) % 3;
+  // Nothing is visible, so there is no frame worth crossfading from.
+  switchScene(kCycleModeId, false);
+  prewarmed_ = true;
+  Serial.print("SceneManager: prewarming internal index ");
+  Serial.println(internal_scene_index_);
+}
+
+void SceneManager::warmup(uint32_t budget_ms) {
+  if (!warming_ || !active_scene_) {
+    return;
+  }
+
+  const uint32_t start_us = micros();
+  const uint32_t budget_us = budget_ms * 1000UL;
+  bool stepped = false;
+  while (warm_remaining_ms_ > 0) {
+    const uint32_t elapsed_us = micros() - start_us;
+    if (elapsed_us >= budget_us) {
+      break;
+    }
+    uint32_t step_ms = warm_remaining_ms_ < kWarmupStepMs ? warm_remaining_ms_ : kWarmupStepMs;
+    if (warm_us_per_ms_ == 0) {
+      // Cost unknown: a 1 ms slice measures it without risking the budget.
+      step_ms = 1;
+    } else {
+      // Only as much simulated time as the rest of the budget pays for at
+      // the measured cost; none when not even 1 ms fits.
+      const uint32_t affordable_ms = (budget_us - elapsed_us) / warm_us_per_ms_;
+      if (affordable_ms == 0) {
+        break;
+      }
+      if (affordable_ms < step_ms) {
+        step_ms = affordable_ms;
+      }
+    }
+
+    const uint32_t slice_start_us = micros();
+    active_scene_->warmup(step_ms);
+    const uint32_t cost_us = (micros() - slice_start_us + step_ms - 1) / step_ms;
+    // Smoothed, since a short slice may or may not cross a simulation step.
+    warm_us_per_ms_ = warm_us_per_ms_ == 0 ? (cost_us ? cost_us : 1)
+                                           : (3 * warm_us_per_ms_ + cost_us + 3) / 4;
+    warm_remaining_ms_ -= step_ms;
+    stepped = true;
+  }
+  if (stepped) {
+    warm_slices_++;
+  }
+
+  if (warm_remaining_ms_ == 0) {
+    warming_ = false;
+    Serial.print("SceneManager: scene mature after ");
+    Serial.print(millis() - warm_start_ms_);
+    Serial.print(" ms (");
+    Serial.print(active_scene_->warmupMs());
+    Serial.print(" ms simulated, ");
+    Serial.print(warm_slices_);
+    Serial.println(" slices)");
+  }
+}
+
+void SceneManager::benchmarkScenes() {
+  // Runs before begin(), so nothing is resident and no Resume state is
+  // touched; the slot is left empty again afterwards.
+  const char *const names[] = {"FlowField", "ReactionDiffusion", "CurlNoise"};
+  KernelBench::printHeader();
+  for (uint8_t target_id = 0; target_id < 3; ++target_id) {
+    Scene &scene = constructScene(target_id);
+    scene.begin(matrix_);
+    KernelBench::runScene(names[target_id], scene, matrix_);
+    BufferOps::waitAll();
+  }
+  slot_.reset();
+  KernelBench::runRdKernels();
+  KernelBench::runNoiseKernels();
+}
+
 void SceneManager::loadState() {
   state_ = flash_store.read();
   if (state_.magic != kMagic) {
@@ -4,7 +4,9 @@
 #include <Adafruit_Protomatter.h>
 #include <FlashStorage.h>
 
+#include "Crossfade.h"
 #include "Scene.h"
+#include "SceneSlot.h"
 #include "scenes/FlowFieldScene.h"
 #include "scenes/ReactionDiffusionScene.h"
 #include "scenes/CurlNoiseScene.h"
@@ -16,11 +18,21 @@ public:
   void begin();
   void tick(uint32_t now_ms);
   void update(uint32_t dt_ms);
-  void render();
   void setWeather(const WeatherParams &params);
   void cycleSceneIfEnabled();
+  // Cycle mode, panel dark: switches to the next scene early so it can be
+  // warmed off-screen. cycleSceneIfEnabled() then keeps it.
+  void prewarmNext();
+  // Fast-forwards a newly switched scene for up to `budget_ms` of wall time,
+  // in slices sized from the measured cost of the ones before; a budget too
+  // short for any slice runs none.
+  void warmup(uint32_t budget_ms);
+  bool warming() const { return warming_; }
+  // Perf builds: runs each scene through KernelBench before begin().
+  void benchmarkScenes();
   
   Scene* getActiveScene() const { return active_scene_; }
+  Crossfade &crossfade() { return crossfade_; }
 
   // Persistent storage structure
   struct PersistentState {
@@ -40,13 +52,26 @@ private:
   uint8_t button_pin_;
   
   PersistentState state_;
+  Crossfade crossfade_;
 
-  // Scenes
-  FlowFieldScene flowFieldScene_;
-  ReactionDiffusionScene reactionDiffusionScene_;
-  CurlNoiseScene curlNoiseScene_;
+  // Only the active scene is resident; the others keep their Resume state.
+  SceneSlot<FlowFieldScene, ReactionDiffusionScene, CurlNoiseScene> slot_;
+  FlowFieldScene::Resume flow_field_resume_;
+  ReactionDiffusionScene::Resume reaction_diffusion_resume_;
+  CurlNoiseScene::Resume curl_noise_resume_;
   Scene *active_scene_;
+  uint8_t active_target_id_;
   uint8_t internal_scene_index_;
+  WeatherParams weather_;
+
+  // Warm-up of the scene most recently switched in
+  static constexpr uint32_t kWarmupStepMs = 33;
+  bool warming_;
+  bool prewarmed_;
+  uint32_t warm_remaining_ms_;
+  uint32_t warm_start_ms_;
+  uint16_t warm_slices_;     // warmup() calls that made progress
+  uint32_t warm_us_per_ms_;  // wall time per simulated ms; 0 until measured
 
   // Button state
   bool last_button_state_;
@@ -55,5 +80,7 @@ private:
 
   void loadState();
   void saveState();
-  void switchScene(uint8_t scene_id);
+  void switchScene(uint8_t scene_id, bool crossfade = true);
+  void leaveActiveScene();
+  Scene &constructScene(uint8_t target_id);
 };
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Scene.h"
+
+namespace SceneSlotDetail {
+constexpr size_t maxOf(size_t a) {
+  return a;
+}
+
+template <typename... Rest>
+constexpr size_t maxOf(size_t a, size_t b, Rest... rest) {
+  return maxOf(a > b ? a : b, rest...);
+}
+
+template <typename T, typename... Ts>
+struct IsOneOf : std::false_type {};
+
+template <typename T, typename First, typename... Rest>
+struct IsOneOf<T, First, Rest...>
+    : std::integral_constant<bool, std::is_same<T, First>::value || IsOneOf<T, Rest...>::value> {};
+} // namespace SceneSlotDetail
+
+// Static storage for the one live scene. The arena is sized and aligned for
+// the largest of `Scenes`, so RAM use is the maximum of the registered
+// scenes rather than their sum. emplace() destroys the current scene before
+// constructing the next one in place; nothing touches the heap.
+template <typename... Scenes>
+class SceneSlot {
+public:
+  static constexpr size_t kBytes = SceneSlotDetail::maxOf(sizeof(Scenes)...);
+  static constexpr size_t kAlign = SceneSlotDetail::maxOf(alignof(Scenes)...);
+
+  SceneSlot() : scene_(nullptr) {}
+  ~SceneSlot() { reset(); }
+
+  SceneSlot(const SceneSlot &) = delete;
+  SceneSlot &operator=(const SceneSlot &) = delete;
+
+  template <typename T, typename... Args>
+  T &emplace(Args &&...args) {
+    static_assert(SceneSlotDetail::IsOneOf<T, Scenes...>::value,
+                  "Scene type is not registered with this SceneSlot");
+    reset();
+    T *scene = new (storage_) T(std::forward<Args>(args)...);
+    scene_ = scene;
+    return *scene;
+  }
+
+  void reset() {
+    if (scene_) {
+      scene_->~Scene();
+      scene_ = nullptr;
+    }
+  }
+
+  Scene *get() const { return scene_; }
+
+  // Only valid while a T is live in the slot.
+  template <typename T>
+  T &as() {
+    static_assert(SceneSlotDetail::IsOneOf<T, Scenes...>::value,
+                  "Scene type is not registered with this SceneSlot");
+    return *static_cast<T *>(scene_);
+  }
+
+private:
+  alignas(kAlign) uint8_t storage_[kBytes];
+  Scene *scene_;
+};
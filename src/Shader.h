@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "RenderTarget.h"
+
+// Per-pixel field scenes: a scene supplies a shader functor that maps a
+// sample position to a palette index, and Shader::renderRows() runs the row
+// loops, steps coordinates incrementally, and writes palette indices or
+// RGB565 depending on the target. Everything is a template, so each scene
+// gets one loop with its shader inlined.
+//
+// A shader provides
+//   void beginRow(Value fy, int y);     // once per evaluated row
+//   uint8_t operator()(Value fx, int x); // palette index for one pixel
+// where Value is the coordinate policy's type. Derive from Shader::Base to
+// get an empty beginRow().
+namespace Shader {
+
+// Coordinate policies.
+struct FloatCoords {
+  using Value = float;
+  static constexpr Value fromFloat(float v) { return v; }
+};
+
+// Q16.16, for shaders written in integer math.
+struct FixedCoords {
+  using Value = int32_t;
+  static constexpr uint8_t kShift = 16;
+  static constexpr Value fromFloat(float v) {
+    return (Value)(v * 65536.0f + (v < 0.0f ? -0.5f : 0.5f));
+  }
+};
+
+// Pixel (x, y) samples (x0 + x * dx, y0 + y * dy).
+template <typename Coords>
+struct Mapping {
+  using Value = typename Coords::Value;
+  Value x0;
+  Value dx;
+  Value y0;
+  Value dy;
+
+  static Mapping make(float x0, float dx, float y0, float dy) {
+    return Mapping{Coords::fromFloat(x0), Coords::fromFloat(dx), Coords::fromFloat(y0),
+                   Coords::fromFloat(dy)};
+  }
+  // Integer pixel coordinates, for shaders that read a grid.
+  static Mapping pixels() { return make(0.0f, 1.0f, 0.0f, 1.0f); }
+};
+
+enum class Rate : uint8_t {
+  kFull,
+  // Every other column is evaluated and copied to its right neighbour.
+  kHalfX,
+  // Only rows of this frame's field (y & 1 == field) are evaluated; the
+  // others repeat the previous frame from the caller's history buffer,
+  // which must hold a whole frame before the first interlaced one.
+  kInterlaced
+};
+
+template <typename Coords>
+struct Base {
+  void beginRow(typename Coords::Value fy, int y) {
+    (void)fy;
+    (void)y;
+  }
+};
+
+namespace Detail {
+template <typename Coords, Rate R, typename Fn, typename Write>
+inline __attribute__((always_inline)) void shadeRow(const Mapping<Coords> &map,
+                                                    typename Coords::Value fy, int y,
+                                                    uint16_t width, Fn &shade, Write write) {
+  using Value = typename Coords::Value;
+  shade.beginRow(fy, y);
+  Value fx = map.x0;
+  if (R == Rate::kHalfX) {
+    const Value dx2 = map.dx + map.dx;
+    for (int x = 0; x < width; x += 2, fx += dx2) {
+      const uint8_t idx = shade(fx, x);
+      write(x, idx);
+      if (x + 1 < width) {
+        write(x + 1, idx);
+      }
+    }
+  } else {
+    for (int x = 0; x < width; ++x, fx += map.dx) {
+      write(x, shade(fx, x));
+    }
+  }
+}
+
+template <typename Coords, Rate R, typename Fn, typename Write>
+inline __attribute__((always_inline)) void shadeRows(const RenderTarget &target, uint16_t y0,
+                                                     uint16_t rows, const Mapping<Coords> &map,
+                                                     Fn &shade, uint8_t *history, uint8_t field,
+                                                     Write write) {
+  using Value = typename Coords::Value;
+  const uint16_t width = target.width;
+  Value fy = map.y0 + (Value)y0 * map.dy;
+  for (int y = y0; y < y0 + rows; ++y, fy += map.dy) {
+    const uint32_t out = (uint32_t)(y - target.row0) * width;
+    if (R == Rate::kInterlaced) {
+      uint8_t *held = history + (uint32_t)y * width;
+      if (((y ^ field) & 1) == 0) {
+        shadeRow<Coords, Rate::kFull>(map, fy, y, width, shade,
+                                      [held](int x, uint8_t idx) { held[x] = idx; });
+      }
+      for (int x = 0; x < width; ++x) {
+        write(out + x, held[x]);
+      }
+    } else {
+      shadeRow<Coords, R>(map, fy, y, width, shade,
+                          [&write, out](int x, uint8_t idx) { write(out + x, idx); });
+    }
+  }
+}
+} // namespace Detail
+
+// Writes palette indices into a whole-frame target from outside
+// renderRows(), for scenes that get a pixel's index as a by-product of
+// their simulation. make() sets target.palette like renderRows() does.
+template <PixelFormat F>
+struct PaletteSink {
+  uint8_t *index;
+  uint16_t *rgb;
+  const uint16_t *palette;
+  uint16_t width;
+
+  static PaletteSink make(RenderTarget &target, const uint16_t *palette) {
+    if (F == PixelFormat::kIndexed8) {
+      target.palette = palette;
+    }
+    return PaletteSink{target.index, target.rgb, palette, target.width};
+  }
+
+  void write(int x, int y, uint8_t idx) const {
+    const uint32_t i = (uint32_t)y * width + x;
+    if (F == PixelFormat::kIndexed8) {
+      index[i] = idx;
+    } else {
+      rgb[i] = palette[idx];
+    }
+  }
+};
+
+// Shades target rows [y0, y0 + rows) (see RenderTarget::row0 for strips).
+// kIndexed8 targets get the indices and `palette`; RGB565 targets get
+// palette colours. kInterlaced needs `history`, one byte per target pixel,
+// kept by the scene across frames, and the frame's `field` (0 or 1). Prime
+// it with a kFull render into a kIndexed8 target over `history`.
+template <typename Coords, Rate R = Rate::kFull, typename Fn>
+inline __attribute__((always_inline)) void renderRows(RenderTarget &target, uint16_t y0,
+                                                      uint16_t rows, const Mapping<Coords> &map,
+                                                      Fn &shade, const uint16_t *palette,
+                                                      uint8_t *history = nullptr,
+                                                      uint8_t field = 0) {
+  if (target.format == PixelFormat::kIndexed8) {
+    target.palette = palette;
+    uint8_t *index = target.index;
+    Detail::shadeRows<Coords, R>(target, y0, rows, map, shade, history, field,
+                                 [index](uint32_t i, uint8_t idx) { index[i] = idx; });
+  } else {
+    uint16_t *rgb = target.rgb;
+    Detail::shadeRows<Coords, R>(target, y0, rows, map, shade, history, field,
+                                 [rgb, palette](uint32_t i, uint8_t idx) { rgb[i] = palette[idx]; });
+  }
+}
+
+} // namespace Shader
@@ -0,0 +1,147 @@
+#include "WeatherOverlay.h"
+
+#include <string.h>
+
+namespace {
+constexpr int32_t kHeightQ8 = (int32_t)kMatrixHeight << 8;
+constexpr int32_t kWidthQ8 = (int32_t)kMatrixWidth << 8;
+// Fall speeds in pixels per second, q8.
+constexpr int16_t kRainFallQ8 = 40 * 256;
+constexpr int16_t kSnowFallQ8 = 6 * 256;
+// Snow sways +-1.5 px/s over this period.
+constexpr uint16_t kSnowSwayMs = 2048;
+constexpr uint16_t kFlashMs = 160;
+constexpr uint8_t kFlashPeakAlpha5 = 18;
+// One flash per this much storm time, on average.
+constexpr uint32_t kFlashMeanIntervalMs = 20000;
+} // namespace
+
+constexpr uint16_t WeatherOverlay::kColors[3];
+
+WeatherOverlay::WeatherOverlay()
+    : particles_{}, count_(0), cover_{}, span_x0_{}, span_x1_{}, dirty_rows_(0),
+      spawn_per_s_(0), kind_(kNone), wind_q8_(0), storm_(false), spawn_accum_(0),
+      flash_ms_(0), flash_alpha5_(0) {}
+
+void WeatherOverlay::setWeather(const WeatherParams &params) {
+  if (!params.valid || params.precip_prob_pct <= APP_OVERLAY_PRECIP_MIN_PCT) {
+    spawn_per_s_ = 0;
+    storm_ = false;
+    return;
+  }
+
+  // Rain at 10-60 drops/s across the precip range; snow a third of that,
+  // since flakes linger on the panel far longer.
+  const uint16_t excess = (uint16_t)(params.precip_prob_pct - APP_OVERLAY_PRECIP_MIN_PCT);
+  const uint16_t span = (uint16_t)(100 - APP_OVERLAY_PRECIP_MIN_PCT);
+  kind_ = params.temp_f <= 34.0f ? kSnow : kRain;
+  spawn_per_s_ = (uint16_t)(10 + (excess * 50) / span);
+  if (kind_ == kSnow) {
+    spawn_per_s_ /= 3;
+  }
+
+  float wind = params.wind_speed_mph;
+  if (wind > 24.0f) {
+    wind = 24.0f;
+  }
+  wind_q8_ = (int16_t)(wind * (kind_ == kSnow ? 128.0f : 256.0f));
+  storm_ = kind_ == kRain && params.precip_prob_pct >= 80 && params.wind_speed_mph >= 15.0f;
+}
+
+void WeatherOverlay::update(uint32_t dt_ms) {
+  clearCoverage();
+
+  spawn_accum_ += spawn_per_s_ * dt_ms;
+  while (spawn_accum_ >= 1000) {
+    spawn_accum_ -= 1000;
+    spawn();
+  }
+
+  for (uint8_t i = 0; i < count_;) {
+    Particle &p = particles_[i];
+    p.age_ms = (uint16_t)(p.age_ms + dt_ms);
+    int32_t vx = p.vx_q8;
+    if (p.kind == kSnow) {
+      // Triangle wave sway, cheaper than sinf per flake.
+      const int32_t phase = p.age_ms & (kSnowSwayMs - 1);
+      const int32_t tri = phase < kSnowSwayMs / 2 ? phase : kSnowSwayMs - phase;
+      vx += (tri * 3 * 256) / (kSnowSwayMs / 2) - 384;
+    }
+    p.x_q8 += (vx * (int32_t)dt_ms) / 1000;
+    p.y_q8 += ((int32_t)p.vy_q8 * (int32_t)dt_ms) / 1000;
+
+    // Particles may start off the side and blow in; plot() clips.
+    if (p.y_q8 >= kHeightQ8 || p.x_q8 < -kWidthQ8 || p.x_q8 >= 2 * kWidthQ8) {
+      // Pooled: the last live particle takes the freed slot.
+      particles_[i] = particles_[--count_];
+      continue;
+    }
+
+    const int32_t x = p.x_q8 >> 8;
+    const int32_t y = p.y_q8 >> 8;
+    if (p.kind == kRain) {
+      // Streak: bright head, fainter tail one step back along the motion.
+      plot(x, y, kRain, 20);
+      plot((p.x_q8 - vx / 20) >> 8, (p.y_q8 - p.vy_q8 / 20) >> 8, kRain, 9);
+    } else {
+      plot(x, y, kSnow, 24);
+    }
+    ++i;
+  }
+
+  if (flash_ms_ > 0) {
+    flash_ms_ = dt_ms >= flash_ms_ ? 0 : (uint16_t)(flash_ms_ - dt_ms);
+  } else if (storm_ && (uint32_t)random(kFlashMeanIntervalMs) < dt_ms) {
+    flash_ms_ = kFlashMs;
+  }
+  flash_alpha5_ = (uint8_t)(((uint32_t)flash_ms_ * kFlashPeakAlpha5) / kFlashMs);
+}
+
+void WeatherOverlay::clearCoverage() {
+  if (dirty_rows_ == 0) {
+    return;
+  }
+  for (uint16_t y = 0; y < kMatrixHeight; ++y) {
+    if (span_x0_[y] < span_x1_[y]) {
+      memset(cover_ + (uint32_t)y * kMatrixWidth + span_x0_[y], 0, span_x1_[y] - span_x0_[y]);
+      span_x0_[y] = 0;
+      span_x1_[y] = 0;
+    }
+  }
+  dirty_rows_ = 0;
+}
+
+void WeatherOverlay::spawn() {
+  if (count_ >= kMaxParticles) {
+    return;
+  }
+  Particle &p = particles_[count_++];
+  p.kind = kind_;
+  p.vx_q8 = wind_q8_;
+  p.vy_q8 = kind_ == kSnow ? kSnowFallQ8 : kRainFallQ8;
+  p.age_ms = (uint16_t)random(kSnowSwayMs);
+  // Start above the panel, shifted upwind so slanted rain still covers it.
+  const int32_t drift = ((int32_t)wind_q8_ * kHeightQ8) / p.vy_q8;
+  p.x_q8 = (int32_t)random(kWidthQ8 + drift) - drift;
+  p.y_q8 = -256;
+}
+
+void WeatherOverlay::plot(int32_t x, int32_t y, uint8_t kind, uint8_t alpha5) {
+  if (x < 0 || y < 0 || x >= kMatrixWidth || y >= kMatrixHeight) {
+    return;
+  }
+  uint8_t &cover = cover_[(uint32_t)y * kMatrixWidth + x];
+  if ((cover & kAlphaMask) >= alpha5) {
+    return;
+  }
+  cover = (uint8_t)((kind << kKindShift) | alpha5);
+  if (span_x0_[y] >= span_x1_[y]) {
+    span_x0_[y] = (uint8_t)x;
+    span_x1_[y] = (uint8_t)(x + 1);
+    ++dirty_rows_;
+  } else if (x < span_x0_[y]) {
+    span_x0_[y] = (uint8_t)x;
+  } else if (x >= span_x1_[y]) {
+    span_x1_[y] = (uint8_t)(x + 1);
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "Crossfade.h"
+#include "Scene.h"
+
+// Rain, snow and lightning drawn over whatever scene is showing. Particles
+// come from a fixed pool and are rasterised into a per-pixel coverage map
+// each update(); Engine blends covered pixels in its post pass, visiting
+// only each row's dirty span. Lightning is a short whole-panel flash.
+class WeatherOverlay {
+public:
+  static constexpr uint8_t kMaxParticles = APP_OVERLAY_MAX_PARTICLES;
+
+  WeatherOverlay();
+
+  void setWeather(const WeatherParams &params);
+  void update(uint32_t dt_ms);
+
+  // Anything to blend this frame.
+  bool visible() const { return dirty_rows_ > 0 || flash_alpha5_ > 0; }
+
+  // Columns [x0, x1) of panel row y that blend() may change; empty when
+  // x0 >= x1.
+  void span(uint16_t y, uint16_t &x0, uint16_t &x1) const {
+    if (flash_alpha5_ > 0) {
+      x0 = 0;
+      x1 = kMatrixWidth;
+      return;
+    }
+    x0 = span_x0_[y];
+    x1 = span_x1_[y];
+  }
+
+  // Composites the overlay over one panel pixel (row-major index).
+  uint16_t blend(uint16_t color, uint32_t pixel) const {
+    const uint8_t cover = cover_[pixel];
+    if (cover) {
+      color = Crossfade::blend565(color, kColors[cover >> kKindShift], cover & kAlphaMask);
+    }
+    if (flash_alpha5_ > 0) {
+      color = Crossfade::blend565(color, kFlashColor, flash_alpha5_);
+    }
+    return color;
+  }
+
+private:
+  enum Kind : uint8_t {
+    kNone,
+    kRain,
+    kSnow
+  };
+
+  // Coverage byte: kind in the top two bits, alpha (0-32) below.
+  static constexpr uint8_t kKindShift = 6;
+  static constexpr uint8_t kAlphaMask = 0x3F;
+  static constexpr uint16_t kColors[3] = {0x0000, 0xA69F, 0xFFFF};
+  static constexpr uint16_t kFlashColor = 0xEF7F;
+  static_assert(kMatrixWidth <= 255, "Dirty spans are stored as uint8_t");
+
+  struct Particle {
+    int32_t x_q8;
+    int32_t y_q8;
+    int16_t vx_q8; // pixels per second, q8
+    int16_t vy_q8;
+    uint16_t age_ms;
+    uint8_t kind;
+  };
+
+  void clearCoverage();
+  void spawn();
+  void plot(int32_t x, int32_t y, uint8_t kind, uint8_t alpha5);
+
+  Particle particles_[kMaxParticles];
+  uint8_t count_;
+
+  uint8_t cover_[(size_t)kMatrixWidth * kMatrixHeight];
+  uint8_t span_x0_[kMatrixHeight];
+  uint8_t span_x1_[kMatrixHeight];
+  uint8_t dirty_rows_;
+
+  // Weather-derived targets
+  uint16_t spawn_per_s_;
+  uint8_t kind_;
+  int16_t wind_q8_;
+  bool storm_;
+  uint32_t spawn_accum_;
+
+  uint16_t flash_ms_;
+  uint8_t flash_alpha5_;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Host stand-in for the Protomatter driver: the same constructor and a
+// plain RGB565 canvas, with show() doing nothing. Only on the include path
+// of the native environment (see platformio.ini).
+
+typedef enum {
+  PROTOMATTER_OK,
+  PROTOMATTER_ERR_PINS,
+  PROTOMATTER_ERR_MALLOC,
+  PROTOMATTER_ERR_ARG,
+} ProtomatterStatus;
+
+class Adafruit_Protomatter {
+public:
+  Adafruit_Protomatter(uint16_t bitWidth, uint8_t bitDepth, uint8_t rgbCount, uint8_t *rgbList,
+                       uint8_t addrCount, uint8_t *addrList, uint8_t clockPin, uint8_t latchPin,
+                       uint8_t oePin, bool doubleBuffer, int8_t tile = 1, void *timer = nullptr);
+  ~Adafruit_Protomatter();
+
+  ProtomatterStatus begin();
+  void show() {}
+  uint16_t *getBuffer() { return buffer_; }
+  int16_t width() const { return width_; }
+  int16_t height() const { return height_; }
+  uint32_t getFrameCount() const { return 0; }
+  void setDuty(uint8_t duty) { (void)duty; }
+
+  void fillScreen(uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  static uint16_t color565(uint8_t red, uint8_t green, uint8_t blue) {
+    return (uint16_t)(((red & 0xF8) << 8) | ((green & 0xFC) << 3) | (blue >> 3));
+  }
+
+private:
+  int16_t width_;
+  int16_t height_;
+  uint16_t *buffer_;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+// Host stand-in for the parts of the Arduino core that the portable sources
+// use: timing, random numbers, pins as no-ops, and Serial on stdout. Only on
+// the include path of the native environment (see platformio.ini).
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+
+class HostSerial {
+public:
+  explicit operator bool() const { return true; }
+  void begin(unsigned long baud) { (void)baud; }
+  int availableForWrite() const { return 256; }
+  void flush();
+
+  size_t print(const char *s);
+  size_t print(char c);
+  size_t print(long v, int base = DEC);
+  size_t print(unsigned long v, int base = DEC);
+  size_t print(double v, int digits = 2);
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(short v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned short v, int base = DEC) { return print((unsigned long)v, base); }
+
+  size_t println() { return print("\n"); }
+  template <typename T>
+  size_t println(T v) {
+    return print(v) + println();
+  }
+  template <typename T>
+  size_t println(T v, int format) {
+    return print(v, format) + println();
+  }
+};
+
+extern HostSerial Serial;
+
+// Milliseconds and microseconds since the first call.
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+inline int digitalRead(uint8_t pin) {
+  (void)pin;
+  return HIGH;
+}
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  (void)pin;
+  (void)value;
+}
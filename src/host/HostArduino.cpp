@@ -0,0 +1,116 @@
+#include <Arduino.h>
+#include <Adafruit_Protomatter.h>
+
+#include <chrono>
+#include <stdio.h>
+#include <thread>
+
+HostSerial Serial;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+Clock::time_point start() {
+  static const Clock::time_point start = Clock::now();
+  return start;
+}
+} // namespace
+
+void HostSerial::flush() {
+  fflush(stdout);
+}
+
+size_t HostSerial::print(const char *s) {
+  return (size_t)printf("%s", s);
+}
+
+size_t HostSerial::print(char c) {
+  return (size_t)printf("%c", c);
+}
+
+size_t HostSerial::print(long v, int base) {
+  return (size_t)(base == HEX ? printf("%lX", (unsigned long)v) : printf("%ld", v));
+}
+
+size_t HostSerial::print(unsigned long v, int base) {
+  return (size_t)(base == HEX ? printf("%lX", v) : printf("%lu", v));
+}
+
+size_t HostSerial::print(double v, int digits) {
+  return (size_t)printf("%.*f", digits, v);
+}
+
+uint32_t millis() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start())
+      .count();
+}
+
+uint32_t micros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start())
+      .count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {}
+
+long random(long max) {
+  return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max) {
+  return max > min ? min + rand() % (max - min) : min;
+}
+
+void randomSeed(unsigned long seed) {
+  srand((unsigned)seed);
+}
+
+Adafruit_Protomatter::Adafruit_Protomatter(uint16_t bitWidth, uint8_t bitDepth, uint8_t rgbCount,
+                                           uint8_t *rgbList, uint8_t addrCount, uint8_t *addrList,
+                                           uint8_t clockPin, uint8_t latchPin, uint8_t oePin,
+                                           bool doubleBuffer, int8_t tile, void *timer)
+    : width_((int16_t)bitWidth), height_((int16_t)(rgbCount * (2 << addrCount))),
+      buffer_(new uint16_t[(size_t)bitWidth * rgbCount * (2 << addrCount)]()) {
+  (void)bitDepth;
+  (void)rgbList;
+  (void)addrList;
+  (void)clockPin;
+  (void)latchPin;
+  (void)oePin;
+  (void)doubleBuffer;
+  (void)tile;
+  (void)timer;
+}
+
+Adafruit_Protomatter::~Adafruit_Protomatter() {
+  delete[] buffer_;
+}
+
+ProtomatterStatus Adafruit_Protomatter::begin() {
+  return PROTOMATTER_OK;
+}
+
+void Adafruit_Protomatter::fillScreen(uint16_t color) {
+  fillRect(0, 0, width_, height_, color);
+}
+
+void Adafruit_Protomatter::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t row = y; row < y + h; ++row) {
+    for (int16_t col = x; col < x + w; ++col) {
+      drawPixel(col, row, color);
+    }
+  }
+}
+
+void Adafruit_Protomatter::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x >= 0 && y >= 0 && x < width_ && y < height_) {
+    buffer_[(size_t)y * width_ + x] = color;
+  }
+}
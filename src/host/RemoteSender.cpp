@@ -0,0 +1,134 @@
+// Remote-render endpoints for the native build (pio run -e native).
+//
+//   program send <address> [port] [flow|rd|curl] [fps]
+//     Runs a scene on the host and streams its frames to a panel built with
+//     APP_REMOTE_RENDER, or to a native receiver.
+//   program listen [port]
+//     Receives a stream the way the panel does and prints its stats, so
+//     both ends can run on one machine over loopback.
+//
+// Excluded from unit-test builds, which bring their own main().
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "net/FrameCodec.h"
+#include "net/RemoteFrameReceiver.h"
+#include "net/UdpTransport.h"
+#include "scenes/CurlNoiseScene.h"
+#include "scenes/FlowFieldScene.h"
+#include "scenes/ReactionDiffusionScene.h"
+
+namespace {
+constexpr uint32_t kPixels = (uint32_t)kMatrixWidth * kMatrixHeight;
+// A key frame this often lets a receiver that lost a packet resynchronise.
+constexpr uint16_t kKeyFrameInterval = 30;
+// The panel's frame pacing (main.cpp).
+constexpr uint32_t kFrameIntervalMs = 33;
+
+uint16_t frame_[kPixels];
+uint16_t reference_[kPixels];
+
+void sendPacket(const uint8_t *packet, size_t len, void *ctx) {
+  static_cast<UdpTransport *>(ctx)->send(packet, len);
+}
+
+Scene *makeScene(const char *name) {
+  static CurlNoiseScene curl;
+  static FlowFieldScene flow;
+  static ReactionDiffusionScene rd;
+  if (strcmp(name, "curl") == 0) {
+    return &curl;
+  }
+  if (strcmp(name, "flow") == 0) {
+    return &flow;
+  }
+  if (strcmp(name, "rd") == 0) {
+    return &rd;
+  }
+  return nullptr;
+}
+
+int send(const char *address, uint16_t port, const char *scene_name, uint32_t fps) {
+  Scene *scene = makeScene(scene_name);
+  if (!scene) {
+    fprintf(stderr, "Sender: unknown scene %s\n", scene_name);
+    return 2;
+  }
+  if (!scene->renderSpec().isPanel()) {
+    fprintf(stderr, "Sender: %s renders below panel size; build with scale 100\n", scene_name);
+    return 2;
+  }
+  UdpTransport transport;
+  if (!transport.begin(0) || !transport.setPeer(address, port)) {
+    fprintf(stderr, "Sender: cannot send to %s:%u\n", address, port);
+    return 1;
+  }
+
+  randomSeed(millis());
+  scene->begin(matrix);
+  FrameCodec::Encoder encoder(kMatrixWidth, kMatrixHeight, reference_);
+  RenderTarget target{kMatrixWidth, kMatrixHeight, PixelFormat::kRgb565, frame_, nullptr, nullptr, 0};
+  const uint32_t interval_ms = 1000 / (fps ? fps : 1);
+  uint32_t last_ms = millis();
+  for (uint32_t n = 0;; ++n) {
+    const uint32_t now_ms = millis();
+    scene->update(now_ms - last_ms);
+    scene->render(target);
+    last_ms = now_ms;
+    encoder.encode(frame_, n % kKeyFrameInterval == 0, sendPacket, &transport);
+    const uint32_t spent_ms = millis() - now_ms;
+    if (spent_ms < interval_ms) {
+      delay(interval_ms - spent_ms);
+    }
+  }
+}
+
+int listen(uint16_t port) {
+  UdpTransport transport;
+  static RemoteFrameReceiver receiver(transport);
+  receiver.begin(port);
+  uint32_t report_ms = millis();
+  for (;;) {
+    const uint32_t now_ms = millis();
+    receiver.tick(now_ms);
+    receiver.present();
+    if (now_ms - report_ms >= 1000) {
+      report_ms = now_ms;
+      const RemoteFrameReceiver::Stats &stats = receiver.stats();
+      printf("Receiver: %s packets=%u frames=%u dropped=%u bad=%u underruns=%u\n",
+             receiver.active(now_ms) ? "active" : "idle", (unsigned)stats.packets,
+             (unsigned)stats.frames, (unsigned)stats.dropped_frames, (unsigned)stats.bad_packets,
+             (unsigned)stats.underruns);
+      fflush(stdout);
+    }
+    delay(kFrameIntervalMs);
+  }
+}
+
+int usage() {
+  fprintf(stderr, "usage: program send <address> [port] [flow|rd|curl] [fps]\n"
+                  "       program listen [port]\n");
+  return 2;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc >= 3 && strcmp(argv[1], "send") == 0) {
+    const uint16_t port = argc > 3 ? (uint16_t)atoi(argv[3]) : APP_REMOTE_PORT;
+    const char *scene = argc > 4 ? argv[4] : "curl";
+    const uint32_t fps = argc > 5 ? (uint32_t)atoi(argv[5]) : 1000 / kFrameIntervalMs;
+    return send(argv[2], port, scene, fps);
+  }
+  if (argc >= 2 && strcmp(argv[1], "listen") == 0) {
+    return listen(argc > 2 ? (uint16_t)atoi(argv[2]) : APP_REMOTE_PORT);
+  }
+  return usage();
+}
+
+#endif
@@ -4,10 +4,17 @@
 
 #include "AppConfig.h"
 #include "BoardConfig.h"
+#include "BufferOps.h"
 #include "Engine.h"
+#include "Perf.h"
+#include "PowerGovernor.h"
 #include "SceneManager.h"
+#include "WeatherOverlay.h"
+#include "net/RemoteFrameReceiver.h"
+#include "net/UdpTransport.h"
 #include "net/WeatherClient.h"
 #include "scenes/FlowFieldScene.h"
+#include "scenes/RemoteScene.h"
 #include "scenes/TestScene.h"
 #include "secrets.h"
 
@@ -45,10 +52,22 @@ static uint32_t wifiNextAttemptMs = 0;
 static uint32_t wifiLastStatusMs = 0;
 static uint32_t wifiSmokeLogMs = 0;
 static uint32_t heapLogLastMs = 0;
+static uint32_t telemetryLogLastMs = 0;
+static uint32_t telemetryLastFrames = 0;
 
 static Engine engine(matrix, kFrameIntervalMs);
 static SceneManager sceneManager(matrix, kButtonPin);
 static WeatherClient weatherClient;
+static PowerGovernor governor;
+#if APP_WEATHER_OVERLAY
+static WeatherOverlay weatherOverlay;
+#endif
+#if APP_REMOTE_RENDER
+static UdpTransport remoteTransport;
+static RemoteFrameReceiver remoteReceiver(remoteTransport);
+static RemoteScene remoteScene(remoteReceiver);
+static bool remoteShowing = false;
+#endif
 
 static void printTimestamp() {
   Serial.print("[");
@@ -179,18 +198,30 @@ void setup() {
     }
   }
 
+  Perf::enableCache();
+  BufferOps::begin();
+
   drawTestPattern();
   delay(1200);
   matrix.fillScreen(0);
   matrix.show();
 
   if (!kWiFiSmokeTest) {
+#if APP_KERNEL_BENCH
+    sceneManager.benchmarkScenes();
+    matrix.fillScreen(0);
+#endif
     sceneManager.begin();
     engine.setScene(sceneManager.getActiveScene());
+    engine.setCrossfade(&sceneManager.crossfade());
+#if APP_WEATHER_OVERLAY
+    engine.setOverlay(&weatherOverlay);
+#endif
     engine.begin();
   }
 
   weatherClient.begin();
+  governor.begin(millis());
   startWiFiConnect(millis());
 }
 
@@ -198,6 +229,22 @@ void loop() {
   const uint32_t nowMs = millis();
   tickWiFi(nowMs);
   weatherClient.tick(nowMs);
+#if APP_REMOTE_RENDER
+  if (wifiState == WiFiState::kConnected) {
+    remoteReceiver.begin(APP_REMOTE_PORT);
+    remoteReceiver.tick(nowMs);
+  } else {
+    remoteReceiver.stop();
+  }
+#endif
+
+  const int32_t utcOffsetS = weatherClient.hasSample()
+                                 ? weatherClient.sample().utc_offset_s
+                                 : (int32_t)APP_UTC_OFFSET_MINUTES * 60;
+  governor.tick(nowMs, wifiState == WiFiState::kConnected, utcOffsetS);
+  const PowerGovernor::Settings &power = governor.current();
+  engine.setFrameInterval(power.frame_interval_ms);
+  weatherClient.setFetchInterval(power.fetch_interval_ms);
 
 #if APP_LOG_HEAP
   if ((uint32_t)(nowMs - heapLogLastMs) >= APP_HEAP_LOG_INTERVAL_MS) {
@@ -208,6 +255,30 @@ void loop() {
   }
 #endif
 
+#if APP_LOG_TELEMETRY
+  if ((uint32_t)(nowMs - telemetryLogLastMs) >= APP_TELEMETRY_LOG_INTERVAL_MS) {
+    const Engine::Stats &stats = engine.stats();
+    const uint32_t elapsedMs = nowMs - telemetryLogLastMs;
+    printTimestamp();
+    Serial.print("Engine: profile=");
+    Serial.print(governor.profileName());
+    Serial.print(" fps=");
+    Serial.print((stats.frames - telemetryLastFrames) * 1000.0f / (float)elapsedMs, 1);
+    Serial.print(" demand=");
+    Serial.print(stats.demand_ma);
+    Serial.print("mA est=");
+    Serial.print(stats.estimated_ma);
+    Serial.print("mA limiter=");
+    Serial.print(stats.limiter_pct);
+    Serial.print("% limited_frames=");
+    Serial.print(stats.limited_frames);
+    Serial.print(" post_frames=");
+    Serial.println(stats.post_frames);
+    telemetryLastFrames = stats.frames;
+    telemetryLogLastMs = nowMs;
+  }
+#endif
+
   if (kWiFiSmokeTest) {
     if ((uint32_t)(nowMs - wifiSmokeLogMs) >= kWiFiSmokeLogIntervalMs) {
       printTimestamp();
@@ -225,9 +296,25 @@ void loop() {
   params.precip_prob_pct = smoothed.precip_prob_pct;
   params.valid = smoothed.valid;
   sceneManager.setWeather(params);
+#if APP_WEATHER_OVERLAY
+  weatherOverlay.setWeather(params);
+#endif
 
   sceneManager.tick(nowMs);
   engine.setScene(sceneManager.getActiveScene());
+#if APP_REMOTE_RENDER
+  // Streamed frames take over while they arrive; the local scene is paused
+  // and picks up again when the stream stops.
+  const bool remote = remoteReceiver.active(nowMs);
+  if (remote != remoteShowing) {
+    printTimestamp();
+    Serial.println(remote ? "Remote: stream started" : "Remote: stream lost, rendering locally");
+    remoteShowing = remote;
+  }
+  if (remote) {
+    engine.setScene(&remoteScene);
+  }
+#endif
   
   // Fade out if weather fetch is approaching or active
   static float current_dimmer = 1.0f;
@@ -257,5 +344,19 @@ void loop() {
     if (current_dimmer > 1.0f) current_dimmer = 1.0f;
   }
 
-  engine.tick(nowMs, current_dimmer);
+  // Warm the next scene while the panel is dark for the fetch; otherwise
+  // only spend time left over before the next frame is due.
+  if (isApproaching && current_dimmer <= 0.0f) {
+    sceneManager.prewarmNext();
+    sceneManager.warmup(APP_PREWARM_DARK_SLICE_MS);
+  } else if (sceneManager.warming()) {
+    const uint32_t idleMs = engine.idleMs(nowMs);
+    if (idleMs > 1) {
+      const uint32_t sliceMs = idleMs - 1;
+      sceneManager.warmup(sliceMs < APP_PREWARM_SPARE_SLICE_MS ? sliceMs
+                                                               : APP_PREWARM_SPARE_SLICE_MS);
+    }
+  }
+
+  engine.tick(nowMs, current_dimmer * power.brightness);
 }
@@ -0,0 +1,184 @@
+#include "FrameCodec.h"
+
+#include <string.h>
+
+namespace FrameCodec {
+namespace {
+constexpr uint8_t kSkipMax = 0x7F;
+constexpr uint8_t kRunTag = 0x80;
+constexpr uint8_t kLiteralTag = 0xC0;
+constexpr uint8_t kCountMask = 0x3F;
+constexpr uint8_t kCountMax = kCountMask + 1;
+// Largest token: tag plus a full literal block.
+constexpr size_t kMaxTokenBytes = 1 + 2 * kCountMax;
+
+void put16(uint8_t *out, uint16_t v) {
+  out[0] = (uint8_t)(v & 0xFF);
+  out[1] = (uint8_t)(v >> 8);
+}
+
+uint16_t get16(const uint8_t *in) {
+  return (uint16_t)(in[0] | (in[1] << 8));
+}
+} // namespace
+
+void writeHeader(const PacketHeader &header, uint8_t *out) {
+  put16(out + 0, kMagic);
+  out[2] = kVersion;
+  out[3] = header.flags;
+  put16(out + 4, header.seq);
+  put16(out + 6, header.base_seq);
+  put16(out + 8, header.width);
+  put16(out + 10, header.height);
+  out[12] = header.fragment;
+  out[13] = 0;
+  put16(out + 14, header.start_pixel);
+}
+
+bool readHeader(const uint8_t *in, size_t len, PacketHeader &out) {
+  if (len < kHeaderBytes || get16(in) != kMagic || in[2] != kVersion) {
+    return false;
+  }
+  out.flags = in[3];
+  out.seq = get16(in + 4);
+  out.base_seq = get16(in + 6);
+  out.width = get16(in + 8);
+  out.height = get16(in + 10);
+  out.fragment = in[12];
+  out.start_pixel = get16(in + 14);
+  return out.fragment < kMaxFragments;
+}
+
+bool decodePayload(const PacketHeader &header, const uint8_t *payload, size_t len,
+                   uint16_t *frame, uint32_t pixels) {
+  const bool key = (header.flags & kKeyFrame) != 0;
+  uint32_t pos = header.start_pixel;
+  size_t i = 0;
+  while (i < len) {
+    const uint8_t tag = payload[i++];
+    if (tag == 0) {
+      return false;
+    }
+    if (tag <= kSkipMax) {
+      // Key frames carry every pixel; a skip would leave stale data.
+      if (key || pos + tag > pixels) {
+        return false;
+      }
+      pos += tag;
+      continue;
+    }
+    const uint32_t count = (uint32_t)(tag & kCountMask) + 1;
+    if (pos + count > pixels) {
+      return false;
+    }
+    if ((tag & kLiteralTag) == kLiteralTag) {
+      if (i + count * 2 > len) {
+        return false;
+      }
+      for (uint32_t n = 0; n < count; ++n, i += 2) {
+        frame[pos++] = get16(payload + i);
+      }
+    } else {
+      if (i + 2 > len) {
+        return false;
+      }
+      const uint16_t value = get16(payload + i);
+      i += 2;
+      for (uint32_t n = 0; n < count; ++n) {
+        frame[pos++] = value;
+      }
+    }
+  }
+  return true;
+}
+
+Encoder::Encoder(uint16_t width, uint16_t height, uint16_t *reference)
+    : width_(width), height_(height), reference_(reference), seq_(0),
+      has_reference_(false) {}
+
+uint16_t Encoder::encode(const uint16_t *frame, bool key_frame, EmitFn emit, void *ctx) {
+  const uint32_t pixels = (uint32_t)width_ * height_;
+  const bool key = key_frame || !has_reference_;
+  const uint16_t base = seq_;
+  ++seq_;
+
+  uint8_t packet[kMaxPacketBytes];
+  PacketHeader header{};
+  header.flags = key ? kKeyFrame : 0;
+  header.seq = seq_;
+  header.base_seq = base;
+  header.width = width_;
+  header.height = height_;
+
+  uint16_t sent = 0;
+  size_t used = 0;
+  uint32_t pos = 0;
+
+  auto unchanged = [&](uint32_t p) { return !key && frame[p] == reference_[p]; };
+  auto flush = [&](bool last) {
+    if (last) {
+      header.flags |= kLastFragment;
+    }
+    writeHeader(header, packet);
+    emit(packet, kHeaderBytes + used, ctx);
+    ++sent;
+    ++header.fragment;
+    header.start_pixel = (uint16_t)pos;
+    used = 0;
+  };
+
+  while (pos < pixels) {
+    if (used + kMaxTokenBytes > kMaxPayloadBytes) {
+      if (header.fragment + 1 >= kMaxFragments) {
+        // Frame abandoned mid-way; restart the chain with a key frame.
+        has_reference_ = false;
+        return 0;
+      }
+      flush(false);
+    }
+    uint8_t *out = packet + kHeaderBytes + used;
+
+    if (unchanged(pos)) {
+      uint32_t n = 1;
+      while (n < kSkipMax && pos + n < pixels && unchanged(pos + n)) {
+        ++n;
+      }
+      out[0] = (uint8_t)n;
+      used += 1;
+      pos += n;
+      continue;
+    }
+
+    uint32_t run = 1;
+    while (run < kCountMax && pos + run < pixels && frame[pos + run] == frame[pos]) {
+      ++run;
+    }
+    if (run >= 2) {
+      out[0] = (uint8_t)(kRunTag | (run - 1));
+      put16(out + 1, frame[pos]);
+      used += 3;
+      pos += run;
+      continue;
+    }
+
+    // Literals until the next run or unchanged pixel.
+    uint32_t n = 1;
+    while (n < kCountMax && pos + n < pixels && !unchanged(pos + n) &&
+           !(pos + n + 1 < pixels && frame[pos + n] == frame[pos + n + 1])) {
+      ++n;
+    }
+    out[0] = (uint8_t)(kLiteralTag | (n - 1));
+    for (uint32_t k = 0; k < n; ++k) {
+      put16(out + 1 + 2 * k, frame[pos + k]);
+    }
+    used += 1 + 2 * n;
+    pos += n;
+  }
+  flush(true);
+
+  memcpy(reference_, frame, pixels * sizeof(uint16_t));
+  has_reference_ = true;
+  return sent;
+}
+
+} // namespace FrameCodec
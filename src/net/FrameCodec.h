@@ -0,0 +1,77 @@
+#pragma once
+
+// Wire format for remote rendering: RGB565 frames streamed as UDP packets
+// from a host renderer to the panel. Deliberately free of Arduino headers
+// so a host-side sender can compile and link it unchanged.
+//
+// Every packet is a 16-byte little-endian header plus a run-length coded
+// payload covering pixels from `start_pixel` on. Key frames code every
+// pixel; delta frames skip pixels equal to frame `base_seq`. A frame is
+// complete once fragments 0..N have arrived, N being the fragment flagged
+// kLastFragment. Each fragment decodes on its own.
+//
+// Payload tokens:
+//   0x01-0x7F  skip n pixels (delta frames only)
+//   0x80-0xBF  repeat the following pixel (n & 0x3F) + 1 times
+//   0xC0-0xFF  (n & 0x3F) + 1 literal pixels follow
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace FrameCodec {
+
+constexpr uint16_t kMagic = 0x464D; // "MF"
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderBytes = 16;
+// Fits a single WiFiNINA UDP buffer with room to spare.
+constexpr size_t kMaxPacketBytes = 1024;
+constexpr size_t kMaxPayloadBytes = kMaxPacketBytes - kHeaderBytes;
+constexpr uint8_t kMaxFragments = 64;
+
+enum Flags : uint8_t {
+  kKeyFrame = 0x01,
+  kLastFragment = 0x02,
+};
+
+struct PacketHeader {
+  uint8_t flags;
+  uint16_t seq;
+  uint16_t base_seq; // delta frames: the frame they apply to
+  uint16_t width;
+  uint16_t height;
+  uint8_t fragment;
+  uint16_t start_pixel;
+};
+
+void writeHeader(const PacketHeader &header, uint8_t *out);
+// False when the packet is too short or not this format/version.
+bool readHeader(const uint8_t *in, size_t len, PacketHeader &out);
+
+// Applies one packet's payload to `frame` (width * height pixels). False on
+// malformed data; the frame may then be partly written.
+bool decodePayload(const PacketHeader &header, const uint8_t *payload, size_t len,
+                   uint16_t *frame, uint32_t pixels);
+
+using EmitFn = void (*)(const uint8_t *packet, size_t len, void *ctx);
+
+// Sender side. Keeps the last encoded frame in caller-provided memory
+// (width * height pixels) so the next one can be sent as a delta.
+class Encoder {
+public:
+  Encoder(uint16_t width, uint16_t height, uint16_t *reference);
+
+  // Packs `frame` into packets and hands each to `emit`. Sends a key frame
+  // when asked or when there is no reference yet. Returns the packet count.
+  uint16_t encode(const uint16_t *frame, bool key_frame, EmitFn emit, void *ctx);
+
+  uint16_t sequence() const { return seq_; }
+
+private:
+  uint16_t width_;
+  uint16_t height_;
+  uint16_t *reference_;
+  uint16_t seq_;
+  bool has_reference_;
+};
+
+} // namespace FrameCodec
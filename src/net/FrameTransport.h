@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Datagram transport under the remote-render codec (FrameCodec.h). The
+// receiver's reassembly and jitter buffer and the host sender only see this
+// interface, so they run unchanged over WiFiNINA on the board and over POSIX
+// sockets on a host (UdpTransport.h).
+class FrameTransport {
+public:
+  virtual ~FrameTransport() = default;
+
+  // Starts listening on `port`. False when the socket could not be opened.
+  virtual bool begin(uint16_t port) = 0;
+  virtual void stop() = 0;
+
+  // Copies the next waiting datagram into `buf` and returns its length; 0
+  // when nothing is waiting, -1 when it did not fit in `cap` and was dropped.
+  virtual int receive(uint8_t *buf, size_t cap) = 0;
+
+  // Sends one datagram to the peer. False when it could not be queued.
+  virtual bool send(const uint8_t *data, size_t len) = 0;
+};
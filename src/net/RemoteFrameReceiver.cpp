@@ -0,0 +1,182 @@
+#include "RemoteFrameReceiver.h"
+
+#include <string.h>
+
+namespace {
+// Bounds the time one tick() spends draining the socket.
+constexpr uint8_t kMaxPacketsPerTick = 24;
+
+uint8_t packet_[FrameCodec::kMaxPacketBytes];
+} // namespace
+
+RemoteFrameReceiver::RemoteFrameReceiver(FrameTransport &transport)
+    : transport_(transport), listening_(false), shown_(kNoSlot), queue_{}, queue_head_(0),
+      queue_count_(0), primed_(false), assembling_(kNoSlot), assembling_seq_(0),
+      fragments_seen_(0), last_fragment_(-1), skipping_(false), skip_seq_(0),
+      last_complete_(kNoSlot), last_complete_seq_(0), last_frame_ms_(0), stats_{} {}
+
+void RemoteFrameReceiver::begin(uint16_t port) {
+  if (listening_) {
+    return;
+  }
+  listening_ = transport_.begin(port);
+  Serial.print("Remote: ");
+  Serial.print(listening_ ? "listening on UDP " : "failed to open UDP ");
+  Serial.println(port);
+}
+
+void RemoteFrameReceiver::stop() {
+  if (listening_) {
+    transport_.stop();
+    listening_ = false;
+  }
+}
+
+void RemoteFrameReceiver::tick(uint32_t now_ms) {
+  if (!listening_) {
+    return;
+  }
+  for (uint8_t i = 0; i < kMaxPacketsPerTick; ++i) {
+    const int len = transport_.receive(packet_, sizeof(packet_));
+    if (len == 0) {
+      break;
+    }
+    if (len < 0) {
+      ++stats_.bad_packets;
+      continue;
+    }
+    handlePacket(packet_, (size_t)len, now_ms);
+  }
+}
+
+bool RemoteFrameReceiver::active(uint32_t now_ms) const {
+  return (shown_ != kNoSlot || queue_count_ >= kDepth) &&
+         (uint32_t)(now_ms - last_frame_ms_) < APP_REMOTE_TIMEOUT_MS;
+}
+
+const uint16_t *RemoteFrameReceiver::present() {
+  if (!primed_ && queue_count_ >= kDepth) {
+    primed_ = true;
+  }
+  if (primed_) {
+    if (queue_count_ == 0) {
+      // Hold the current frame and let the buffer refill.
+      ++stats_.underruns;
+      primed_ = false;
+    } else {
+      shown_ = queue_[queue_head_];
+      queue_head_ = (uint8_t)((queue_head_ + 1) % kDepth);
+      --queue_count_;
+    }
+  }
+  return shown_ == kNoSlot ? nullptr : frames_[shown_];
+}
+
+void RemoteFrameReceiver::handlePacket(const uint8_t *packet, size_t len, uint32_t now_ms) {
+  ++stats_.packets;
+  FrameCodec::PacketHeader header;
+  if (!FrameCodec::readHeader(packet, len, header) || header.width != kMatrixWidth ||
+      header.height != kMatrixHeight) {
+    ++stats_.bad_packets;
+    return;
+  }
+
+  if (assembling_ == kNoSlot || header.seq != assembling_seq_) {
+    // Late fragments of a frame already finished or given up on. After a
+    // timeout anything goes, so a restarted sender is picked up again.
+    const bool stale = (uint32_t)(now_ms - last_frame_ms_) >= APP_REMOTE_TIMEOUT_MS;
+    if (last_complete_ != kNoSlot && !stale && (int16_t)(header.seq - last_complete_seq_) <= 0) {
+      return;
+    }
+    if (skipping_ && header.seq == skip_seq_) {
+      return;
+    }
+    if (assembling_ != kNoSlot) {
+      ++stats_.dropped_frames;
+      assembling_ = kNoSlot;
+    }
+    if (!startFrame(header)) {
+      skip(header.seq);
+      return;
+    }
+  }
+
+  const uint64_t bit = 1ULL << header.fragment;
+  if (fragments_seen_ & bit) {
+    return;
+  }
+  if (!FrameCodec::decodePayload(header, packet + FrameCodec::kHeaderBytes,
+                                 len - FrameCodec::kHeaderBytes, frames_[assembling_],
+                                 kPixels)) {
+    ++stats_.bad_packets;
+    ++stats_.dropped_frames;
+    assembling_ = kNoSlot;
+    skip(header.seq);
+    return;
+  }
+  fragments_seen_ |= bit;
+  if (header.flags & FrameCodec::kLastFragment) {
+    last_fragment_ = (int8_t)header.fragment;
+  }
+  if (last_fragment_ >= 0) {
+    const uint64_t all = (last_fragment_ == 63) ? ~0ULL : ((1ULL << (last_fragment_ + 1)) - 1);
+    if (fragments_seen_ == all) {
+      completeFrame(now_ms);
+    }
+  }
+}
+
+bool RemoteFrameReceiver::startFrame(const FrameCodec::PacketHeader &header) {
+  const bool key = (header.flags & FrameCodec::kKeyFrame) != 0;
+  if (!key && (last_complete_ == kNoSlot || header.base_seq != last_complete_seq_)) {
+    ++stats_.dropped_frames;
+    return false;
+  }
+  const int8_t slot = freeSlot();
+  if (slot == kNoSlot) {
+    return false;
+  }
+  if (!key) {
+    memcpy(frames_[slot], frames_[last_complete_], sizeof(frames_[0]));
+  }
+  assembling_ = slot;
+  assembling_seq_ = header.seq;
+  fragments_seen_ = 0;
+  last_fragment_ = -1;
+  return true;
+}
+
+void RemoteFrameReceiver::completeFrame(uint32_t now_ms) {
+  if (queue_count_ == kDepth) {
+    // Sender is running ahead of the panel; drop the oldest queued frame.
+    queue_head_ = (uint8_t)((queue_head_ + 1) % kDepth);
+    --queue_count_;
+    ++stats_.dropped_frames;
+  }
+  queue_[(queue_head_ + queue_count_) % kDepth] = assembling_;
+  ++queue_count_;
+
+  last_complete_ = assembling_;
+  last_complete_seq_ = assembling_seq_;
+  assembling_ = kNoSlot;
+  last_frame_ms_ = now_ms;
+  ++stats_.frames;
+}
+
+void RemoteFrameReceiver::skip(uint16_t seq) {
+  skipping_ = true;
+  skip_seq_ = seq;
+}
+
+int8_t RemoteFrameReceiver::freeSlot() const {
+  for (int8_t slot = 0; slot < kSlots; ++slot) {
+    bool used = slot == shown_ || slot == assembling_;
+    for (uint8_t i = 0; i < queue_count_ && !used; ++i) {
+      used = queue_[(queue_head_ + i) % kDepth] == slot;
+    }
+    if (!used) {
+      return slot;
+    }
+  }
+  return kNoSlot;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "FrameCodec.h"
+#include "FrameTransport.h"
+
+// Receives FrameCodec packets from a FrameTransport and reassembles them
+// into panel frames. Completed frames wait in a short jitter buffer so uneven Wi-Fi
+// delivery does not show up as uneven motion; present() hands out one per
+// rendered frame once the buffer has filled.
+//
+// Delta frames only apply on top of the frame they were encoded against. A
+// lost packet breaks that chain, and everything is dropped until the next
+// key frame, so senders should emit one periodically.
+class RemoteFrameReceiver {
+public:
+  struct Stats {
+    uint32_t packets;
+    uint32_t frames;         // fully assembled
+    uint32_t dropped_frames; // incomplete, or no base to apply to
+    uint32_t bad_packets;    // wrong format, size or payload
+    uint32_t underruns;      // present() found the jitter buffer empty
+  };
+
+  static constexpr uint32_t kPixels = (uint32_t)kMatrixWidth * kMatrixHeight;
+
+  explicit RemoteFrameReceiver(FrameTransport &transport);
+
+  void begin(uint16_t port);
+  void stop();
+  // Drains pending packets; call every loop().
+  void tick(uint32_t now_ms);
+
+  // True while frames keep arriving (within APP_REMOTE_TIMEOUT_MS) and the
+  // jitter buffer has filled at least once.
+  bool active(uint32_t now_ms) const;
+
+  // Advances to the next buffered frame if the jitter buffer allows it and
+  // returns the frame to show (null before the first one).
+  const uint16_t *present();
+
+  const Stats &stats() const { return stats_; }
+
+private:
+  static constexpr uint8_t kDepth = APP_REMOTE_JITTER_FRAMES;
+  // Shown + queued + assembling.
+  static constexpr uint8_t kSlots = kDepth + 2;
+  static constexpr int8_t kNoSlot = -1;
+
+  void handlePacket(const uint8_t *packet, size_t len, uint32_t now_ms);
+  bool startFrame(const FrameCodec::PacketHeader &header);
+  void completeFrame(uint32_t now_ms);
+  // Ignores the remaining fragments of a frame that was given up on, so it
+  // is counted as dropped once.
+  void skip(uint16_t seq);
+  int8_t freeSlot() const;
+
+  FrameTransport &transport_;
+  bool listening_;
+
+  uint16_t frames_[kSlots][kPixels];
+  int8_t shown_;
+  int8_t queue_[kDepth];
+  uint8_t queue_head_;
+  uint8_t queue_count_;
+  bool primed_;
+
+  // Frame being assembled.
+  int8_t assembling_;
+  uint16_t assembling_seq_;
+  uint64_t fragments_seen_;
+  int8_t last_fragment_;
+  bool skipping_;
+  uint16_t skip_seq_;
+
+  // Newest complete frame, the only valid base for a delta.
+  int8_t last_complete_;
+  uint16_t last_complete_seq_;
+
+  uint32_t last_frame_ms_;
+  Stats stats_;
+};
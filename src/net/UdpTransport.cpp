@@ -0,0 +1,130 @@
+#include "UdpTransport.h"
+
+#if defined(__SAMD51__)
+
+UdpTransport::UdpTransport() : open_(false), peer_host_(nullptr), peer_port_(0) {}
+
+UdpTransport::~UdpTransport() {
+  stop();
+}
+
+bool UdpTransport::begin(uint16_t port) {
+  if (!open_) {
+    open_ = udp_.begin(port) != 0;
+  }
+  return open_;
+}
+
+void UdpTransport::stop() {
+  if (open_) {
+    udp_.stop();
+    open_ = false;
+  }
+}
+
+int UdpTransport::receive(uint8_t *buf, size_t cap) {
+  if (!open_) {
+    return 0;
+  }
+  const int size = udp_.parsePacket();
+  if (size <= 0) {
+    return 0;
+  }
+  if ((size_t)size > cap) {
+    // parsePacket() discards the rest of this datagram on the next call.
+    return -1;
+  }
+  const int len = udp_.read(buf, cap);
+  return len > 0 ? len : 0;
+}
+
+bool UdpTransport::send(const uint8_t *data, size_t len) {
+  if (!open_ || !peer_host_) {
+    return false;
+  }
+  return udp_.beginPacket(peer_host_, peer_port_) && udp_.write(data, len) == len &&
+         udp_.endPacket();
+}
+
+bool UdpTransport::setPeer(const char *host, uint16_t port) {
+  peer_host_ = host;
+  peer_port_ = port;
+  return host != nullptr;
+}
+
+#else
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+UdpTransport::UdpTransport() : fd_(-1), peer_addr_(0), peer_port_(0) {}
+
+UdpTransport::~UdpTransport() {
+  stop();
+}
+
+bool UdpTransport::begin(uint16_t port) {
+  if (fd_ >= 0) {
+    return true;
+  }
+  fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd_ < 0) {
+    return false;
+  }
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(fd_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+      fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL, 0) | O_NONBLOCK) != 0) {
+    stop();
+    return false;
+  }
+  return true;
+}
+
+void UdpTransport::stop() {
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+int UdpTransport::receive(uint8_t *buf, size_t cap) {
+  if (fd_ < 0) {
+    return 0;
+  }
+  // MSG_TRUNC reports the full datagram size, so an oversized one is caught.
+  const ssize_t size = recv(fd_, buf, cap, MSG_TRUNC);
+  if (size < 0) {
+    return 0;
+  }
+  return (size_t)size > cap ? -1 : (int)size;
+}
+
+bool UdpTransport::send(const uint8_t *data, size_t len) {
+  if (fd_ < 0 || peer_port_ == 0) {
+    return false;
+  }
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = peer_addr_;
+  addr.sin_port = htons(peer_port_);
+  return sendto(fd_, data, len, 0, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) ==
+         (ssize_t)len;
+}
+
+bool UdpTransport::setPeer(const char *host, uint16_t port) {
+  in_addr addr;
+  if (inet_pton(AF_INET, host, &addr) != 1) {
+    return false;
+  }
+  peer_addr_ = addr.s_addr;
+  peer_port_ = port;
+  return true;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "FrameTransport.h"
+
+#if defined(__SAMD51__)
+#include <WiFiNINA.h>
+#endif
+
+// FrameTransport over UDP: WiFiNINA's WiFiUDP on the board, a non-blocking
+// POSIX socket elsewhere (the native build's sender and tests).
+class UdpTransport : public FrameTransport {
+public:
+  UdpTransport();
+  ~UdpTransport() override;
+
+  bool begin(uint16_t port) override;
+  void stop() override;
+  int receive(uint8_t *buf, size_t cap) override;
+  bool send(const uint8_t *data, size_t len) override;
+
+  // Where send() goes. `host` is a dotted IPv4 address (a host name is also
+  // accepted on the board) and must outlive the transport.
+  bool setPeer(const char *host, uint16_t port);
+
+private:
+#if defined(__SAMD51__)
+  WiFiUDP udp_;
+  bool open_;
+  const char *peer_host_;
+#else
+  int fd_;
+  uint32_t peer_addr_; // network byte order
+#endif
+  uint16_t peer_port_;
+};
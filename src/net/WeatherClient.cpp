@@ -97,6 +97,7 @@ WeatherClient::WeatherClient()
       connect_start_ms_(0),
       last_io_ms_(0),
       last_smooth_ms_(0),
+      fetch_interval_ms_(kFetchIntervalMs),
       backoff_index_(0),
       connect_attempted_(false),
       logged_first_bytes_(false),
@@ -164,6 +165,14 @@ bool WeatherClient::hasSample() const {
   return sample_.valid;
 }
 
+void WeatherClient::setFetchInterval(uint32_t interval_ms) {
+  fetch_interval_ms_ = interval_ms;
+}
+
+uint32_t WeatherClient::fetchInterval() const {
+  return fetch_interval_ms_;
+}
+
 bool WeatherClient::isApproachingFetch(uint32_t now_ms, uint32_t lead_time_ms) const {
   // If we are actively doing something, we are "fetching"
   if (state_ != State::kIdle && state_ != State::kCoolDown && state_ != State::kDisconnected) {
@@ -971,6 +980,8 @@ bool WeatherClient::parseBody(WeatherSample &out) {
   out.wind_speed_mph = wind;
   out.cloud_cover_pct = (uint8_t)cloud;
   out.precip_prob_pct = (uint8_t)precip;
+  // Requested with timezone=auto, so this follows the configured location.
+  out.utc_offset_s = doc["utc_offset_seconds"] | 0;
   return true;
 }
 
@@ -1034,7 +1045,7 @@ void WeatherClient::handleParse(uint32_t now_ms) {
 void WeatherClient::scheduleSuccess(uint32_t now_ms) {
   abortRequest();
   backoff_index_ = 0;
-  next_fetch_ms_ = now_ms + kFetchIntervalMs;
+  next_fetch_ms_ = now_ms + fetch_interval_ms_;
 #if WEATHER_LOG_ENABLED
   if (canLog()) {
     logTimestamp();
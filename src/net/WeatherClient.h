@@ -20,6 +20,7 @@ public:
     uint8_t cloud_cover_pct;
     float wind_speed_mph;
     uint8_t precip_prob_pct;
+    int32_t utc_offset_s; // local time offset reported for the location
     uint32_t sampled_at_ms;
     bool valid;
   };
@@ -32,6 +33,10 @@ public:
   const WeatherSample &sample() const;
   const WeatherSample &smoothed() const;
   bool hasSample() const;
+
+  // Interval between successful fetches (failures use the backoff schedule).
+  void setFetchInterval(uint32_t interval_ms);
+  uint32_t fetchInterval() const;
   
   // Returns true if a fetch is about to happen (within lead_time_ms) or is happening.
   bool isApproachingFetch(uint32_t now_ms, uint32_t lead_time_ms = 2000) const;
@@ -86,6 +91,7 @@ private:
   uint32_t connect_start_ms_;
   uint32_t last_io_ms_;
   uint32_t last_smooth_ms_;
+  uint32_t fetch_interval_ms_;
   uint8_t backoff_index_;
   bool connect_attempted_;
   bool logged_first_bytes_;
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+
+#include "AppConfig.h"
+#include "Noise.h"
+#include "Shader.h"
+
+// The Curl scene's shaders: the curl of a noise potential coloured by
+// direction, per pixel or interpolated from a coarse lattice.
+namespace CurlKernels {
+
+// Noise potential psi, the direction bucket of its curl, and lattice
+// interpolation, for the coordinate type in use: Q16.16 with
+// APP_CURL_FIXED_NOISE, float otherwise.
+#if APP_CURL_FIXED_NOISE
+inline Noise::GradientQ16 potential(int32_t x, int32_t y, int32_t z) {
+  return Noise::perlinGradientQ16(x, y, z);
+}
+
+// Curl in 2D: V = (d_psi/dy, -d_psi/dx); its angle picks the colour.
+// atan2(-dx, dy) + PI, as the float shader takes, is the direction of
+// (-dy, dx).
+inline uint8_t curlSector(int32_t dx, int32_t dy) {
+  return Noise::sector16(-dy, dx);
+}
+
+// d * frac / 2^shift, for frac < 2^shift.
+inline int32_t fraction(int32_t d, int frac, uint8_t shift) {
+  return (d * frac) >> shift;
+}
+#else
+inline Noise::Gradient potential(float x, float y, float z) {
+  return Noise::perlinGradient(x, y, z);
+}
+
+// Curl in 2D: V = (d_psi/dy, -d_psi/dx); its angle picks the colour.
+inline uint8_t curlSector(float dx, float dy) {
+  const float angle = atan2f(-dx, dy) + (float)M_PI; // 0 to 2PI
+  return (uint8_t)((int)(angle * 16.0f / (2.0f * (float)M_PI)) & 0x0F);
+}
+
+// d * frac / 2^shift, for frac < 2^shift.
+inline float fraction(float d, int frac, uint8_t shift) {
+  static const float kScale[] = {1.0f, 0.5f, 0.25f, 0.125f};
+  return d * (float)frac * kScale[shift];
+}
+#endif
+
+// Colours the curl of the noise potential by its direction.
+template <typename Coords>
+struct CurlShader {
+  using Value = typename Coords::Value;
+  Value z;
+  Value fy;
+  uint8_t slots[16]; // direction bucket -> palette index
+
+  void beginRow(Value y, int) { fy = y; }
+
+  uint8_t operator()(Value fx, int) const {
+    const auto psi = potential(fx, fy, z);
+    return slots[curlSector(psi.dx, psi.dy)];
+  }
+};
+
+// CurlShader with psi's gradient evaluated only on lattice nodes every
+// 2^shift pixels and interpolated bilinearly in between; the curl is
+// linear in it, so this interpolates the curl vector. Lattice rows are
+// evaluated as the rows reach them, two at a time.
+template <typename Coords, uint16_t kMaxNodes>
+struct CurlLatticeShader {
+  using Value = typename Coords::Value;
+  struct Node {
+    Value dx;
+    Value dy;
+  };
+
+  Shader::Mapping<Coords> map;
+  Value z;
+  uint8_t shift;
+  uint16_t nodes; // per lattice row
+  int row;        // lattice row held in above
+  uint8_t slots[16];
+  Node above[kMaxNodes];
+  Node below[kMaxNodes];
+  Node blend[kMaxNodes]; // above to below at the current pixel row
+
+  void evaluateRow(int j, Node *out) const {
+    const Value fy = map.y0 + (Value)(j << shift) * map.dy;
+    const Value step = map.dx * (Value)(1 << shift);
+    Value fx = map.x0;
+    for (uint16_t i = 0; i < nodes; ++i, fx += step) {
+      const auto psi = potential(fx, fy, z);
+      out[i] = Node{psi.dx, psi.dy};
+    }
+  }
+
+  void beginRow(Value, int y) {
+    const int j = y >> shift;
+    if (j != row) {
+      if (j == row + 1) {
+        memcpy(above, below, nodes * sizeof(Node));
+      } else {
+        evaluateRow(j, above);
+      }
+      evaluateRow(j + 1, below);
+      row = j;
+    }
+    const int frac = y & ((1 << shift) - 1);
+    for (uint16_t i = 0; i < nodes; ++i) {
+      blend[i].dx = above[i].dx + fraction(below[i].dx - above[i].dx, frac, shift);
+      blend[i].dy = above[i].dy + fraction(below[i].dy - above[i].dy, frac, shift);
+    }
+  }
+
+  uint8_t operator()(Value, int x) const {
+    const Node &a = blend[x >> shift];
+    const Node &b = blend[(x >> shift) + 1];
+    const int frac = x & ((1 << shift) - 1);
+    return slots[curlSector(a.dx + fraction(b.dx - a.dx, frac, shift),
+                            a.dy + fraction(b.dy - a.dy, frac, shift))];
+  }
+};
+
+#if APP_CURL_FIXED_NOISE
+using CurlCoords = Shader::FixedCoords;
+#else
+using CurlCoords = Shader::FloatCoords;
+#endif
+
+// Widest lattice spacing, in noise units: the interpolated curl still
+// lands in the per-pixel palette slot or the one next to it at about 99%
+// of pixels. On a 64x32 panel that is 17x9 nodes at the cloudiest
+// settings and 33x17 at the clearest.
+constexpr float kMaxNodeSpacing = 0.25f;
+constexpr uint8_t kMaxLatticeShift = 3;
+
+// Lattice spacing for `scale` noise units per pixel as a shift, or 0 to
+// shade every pixel. The scene skips the lattice without APP_CURL_LATTICE.
+inline uint8_t latticeShift(float scale) {
+  uint8_t shift = 0;
+  while (shift < kMaxLatticeShift && (float)(2 << shift) * scale <= kMaxNodeSpacing) {
+    ++shift;
+  }
+  return shift;
+}
+
+} // namespace CurlKernels
@@ -1,19 +1,43 @@
 #pragma once
 
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "Geometry.h"
 #include "Scene.h"
 #include <Adafruit_Protomatter.h>
 
-class CurlNoiseScene : public Scene {
+// Instantiated for PanelGeometry in CurlNoiseScene.cpp.
+template <typename G>
+class CurlNoiseSceneT : public Scene {
 public:
-  CurlNoiseScene();
+  // State kept by SceneManager while the scene is not resident. A negative
+  // z_offset means "not started": begin() picks a random start.
+  struct Resume {
+    float z_offset = -1.0f;
+  };
+
+  CurlNoiseSceneT();
+  explicit CurlNoiseSceneT(const Resume &resume);
+  Resume resume() const;
   void begin(Adafruit_Protomatter &matrix) override;
   void update(uint32_t dt_ms) override;
-  void render(Adafruit_Protomatter &matrix) override;
+  RenderSpec renderSpec() const override;
+  void render(RenderTarget &target) override;
+  bool supportsRowRange() const override { return true; }
+  void renderRows(RenderTarget &target, uint16_t y0, uint16_t rows) override;
   void setWeather(const WeatherParams &params) override;
 
 private:
+  // Curl is smooth enough to render below panel resolution and upscale.
+  using Grid = ScaledGeometry<G, APP_CURL_RENDER_SCALE_PCT>;
+  static constexpr uint16_t kRenderWidth = Grid::kWidth;
+  static constexpr uint16_t kRenderHeight = Grid::kHeight;
+  static_assert(APP_STRIP_ROWS > 0
+                    ? RenderSpec{kRenderWidth, kRenderHeight, PixelFormat::kRgb565, Upscale::kBilinear}.fitsStrips()
+                    : RenderSpec{kRenderWidth, kRenderHeight, PixelFormat::kRgb565, Upscale::kBilinear}.fitsScratch(),
+                "Curl render size does not fit the Engine render scratch");
+
   void updatePalette();
-  float noise3D(float x, float y, float z);
 
   // Scene state
   float z_offset_;
@@ -32,3 +56,5 @@ private:
   uint8_t allowed_count_;
   uint8_t cold_green_scale_q8_;
 };
+
+using CurlNoiseScene = CurlNoiseSceneT<PanelGeometry>;
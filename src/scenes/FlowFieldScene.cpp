@@ -1,10 +1,11 @@
 #include "scenes/FlowFieldScene.h"
 
 #include "BoardConfig.h"
+#include "BufferOps.h"
 #include "PaletteUtils.h"
 
 namespace {
-constexpr FlowFieldScene::Vec2 kDirections[16] = {
+constexpr FlowFieldVec2 kDirections[16] = {
   {256, 0},
   {237, 98},
   {181, 181},
@@ -54,8 +55,12 @@ float lerp(float a, float b, float t) {
 }
 } // namespace
 
-FlowFieldScene::FlowFieldScene()
-    : rng_(0x12345678),
+template <typename G>
+FlowFieldSceneT<G>::FlowFieldSceneT() : FlowFieldSceneT(Resume{}) {}
+
+template <typename G>
+FlowFieldSceneT<G>::FlowFieldSceneT(const Resume &resume)
+    : rng_(resume.rng),
       field_accum_ms_(0),
       drift_accum_ms_(0),
       field_cursor_(0),
@@ -83,18 +88,32 @@ FlowFieldScene::FlowFieldScene()
       particles_{},
       weather_{} {}
 
-uint32_t FlowFieldScene::nextRand(uint32_t &state) {
+template <typename G>
+typename FlowFieldSceneT<G>::Resume FlowFieldSceneT<G>::resume() const {
+  Resume resume;
+  resume.rng = rng_;
+  return resume;
+}
+
+template <typename G>
+uint32_t FlowFieldSceneT<G>::nextRand(uint32_t &state) {
   state ^= state << 13;
   state ^= state >> 17;
   state ^= state << 5;
   return state;
 }
 
-FlowFieldScene::Vec2 FlowFieldScene::direction(uint8_t idx) {
+template <typename G>
+FlowFieldVec2 FlowFieldSceneT<G>::direction(uint8_t idx) {
   return kDirections[idx & 0x0F];
 }
 
-void FlowFieldScene::begin(Adafruit_Protomatter &matrix) {
+template <typename G>
+void FlowFieldSceneT<G>::begin(Adafruit_Protomatter &matrix) {
+  // Clear the trail buffer in the background while particles are seeded.
+  const BufferOps::Fence clear_fence =
+      BufferOps::fill16(sim_buffer_, 0, sizeof(sim_buffer_) / sizeof(sim_buffer_[0]));
+
   rng_ ^= millis();
   field_accum_ms_ = 0;
   drift_accum_ms_ = 0;
@@ -110,16 +129,14 @@ void FlowFieldScene::begin(Adafruit_Protomatter &matrix) {
   updatePalette(128);
 
   for (uint16_t i = 0; i < kParticleCount; ++i) {
-    const uint16_t x = (uint16_t)(nextRand(rng_) % kMatrixWidth);
-    const uint16_t y = (uint16_t)(nextRand(rng_) % kMatrixHeight);
+    const uint16_t x = (uint16_t)G::modX(nextRand(rng_));
+    const uint16_t y = (uint16_t)G::modY(nextRand(rng_));
     particles_[i].x_fp = (int32_t)(x << kFixedShift);
     particles_[i].y_fp = (int32_t)(y << kFixedShift);
     particles_[i].age = (uint8_t)(nextRand(rng_) & 0xFF);
     particles_[i].pad = 0;
   }
 
-  memset(sim_buffer_, 0, sizeof(sim_buffer_));
-
   weather_.valid = false;
   field_update_interval_ms_ = kFieldUpdateIntervalMs;
   fade_factor_ = kFadeFactor;
@@ -139,9 +156,24 @@ void FlowFieldScene::begin(Adafruit_Protomatter &matrix) {
   last_wind_ = 0xFF;
   last_precip_ = 0xFF;
   last_temp_log_q_ = -32768;
+
+  BufferOps::wait(clear_fence);
 }
 
-void FlowFieldScene::update(uint32_t dt_ms) {
+template <typename G>
+uint32_t FlowFieldSceneT<G>::warmupMs() const {
+  return kWarmupMs;
+}
+
+template <typename G>
+void FlowFieldSceneT<G>::warmup(uint32_t dt_ms) {
+  // Trails only build up as frames are drawn, so warm-up draws them too.
+  update(dt_ms);
+  drawTrails();
+}
+
+template <typename G>
+void FlowFieldSceneT<G>::update(uint32_t dt_ms) {
   field_accum_ms_ += dt_ms;
   while (field_accum_ms_ >= field_update_interval_ms_) {
     field_accum_ms_ -= field_update_interval_ms_;
@@ -164,13 +196,18 @@ void FlowFieldScene::update(uint32_t dt_ms) {
     }
   }
 
+  advanceParticles(dt_ms);
+}
+
+template <typename G>
+void FlowFieldSceneT<G>::advanceParticles(uint32_t dt_ms) {
   for (uint16_t i = 0; i < active_particles_; ++i) {
     Particle &p = particles_[i];
     const int16_t x = (int16_t)(p.x_fp >> kFixedShift);
     const int16_t y = (int16_t)(p.y_fp >> kFixedShift);
 
-    const uint8_t fx = (uint8_t)((uint16_t)x * kFieldCols / kMatrixWidth);
-    const uint8_t fy = (uint8_t)((uint16_t)y * kFieldRows / kMatrixHeight);
+    const uint16_t fx = (uint16_t)((uint16_t)x >> kFieldCellShift);
+    const uint16_t fy = (uint16_t)((uint16_t)y >> kFieldCellShift);
     const uint16_t field_index = (uint16_t)(fy * kFieldCols + fx);
     const Vec2 dir = direction(field_[field_index]);
 
@@ -180,8 +217,8 @@ void FlowFieldScene::update(uint32_t dt_ms) {
     p.x_fp += (vx_fp * (int32_t)dt_ms) / 1000;
     p.y_fp += (vy_fp * (int32_t)dt_ms) / 1000;
 
-    const int32_t max_x = (int32_t)kMatrixWidth * kFixedOne;
-    const int32_t max_y = (int32_t)kMatrixHeight * kFixedOne;
+    const int32_t max_x = (int32_t)G::kWidth * kFixedOne;
+    const int32_t max_y = (int32_t)G::kHeight * kFixedOne;
 
     if (p.x_fp < 0) {
       p.x_fp += max_x;
@@ -199,14 +236,15 @@ void FlowFieldScene::update(uint32_t dt_ms) {
 
     // Respawn old particles to prevent clumping in sinkholes
     if (p.age > 240 + (i & 0x0F)) {
-      p.x_fp = (int32_t)((nextRand(rng_) % kMatrixWidth) << kFixedShift);
-      p.y_fp = (int32_t)((nextRand(rng_) % kMatrixHeight) << kFixedShift);
+      p.x_fp = (int32_t)(G::modX(nextRand(rng_)) << kFixedShift);
+      p.y_fp = (int32_t)(G::modY(nextRand(rng_)) << kFixedShift);
       p.age = (uint8_t)(nextRand(rng_) & 0x3F); // Start young
     }
   }
 }
 
-void FlowFieldScene::render(Adafruit_Protomatter &matrix) {
+template <typename G>
+void FlowFieldSceneT<G>::render(RenderTarget &target) {
   if (first_render_) {
     Serial.print("[");
     Serial.print(millis());
@@ -214,8 +252,35 @@ void FlowFieldScene::render(Adafruit_Protomatter &matrix) {
     first_render_ = false;
   }
 
+  drawTrails();
+
+  // Engine waits for the copy before post-processing the frame.
+  BufferOps::copy(target.rgb, sim_buffer_, sizeof(sim_buffer_));
+}
+
+template <typename G>
+void FlowFieldSceneT<G>::drawTrails() {
+  fadeTrails();
+
   uint16_t *buffer = sim_buffer_;
-  const uint32_t count = (uint32_t)kMatrixWidth * kMatrixHeight;
+  for (uint16_t i = 0; i < active_particles_; ++i) {
+    const int16_t x = (int16_t)(particles_[i].x_fp >> kFixedShift);
+    const int16_t y = (int16_t)(particles_[i].y_fp >> kFixedShift);
+    if ((uint16_t)x < G::kWidth && (uint16_t)y < G::kHeight) {
+      // Stable color based on particle index to prevent twinkling
+      const uint8_t base = (uint8_t)((i % 16) + palette_offset_);
+      const uint8_t count = (allowed_count_ == 0) ? 1 : allowed_count_;
+      const uint8_t mapped = allowed_indices_[base % count];
+      const uint8_t idx = mapped & 0x0F;
+      buffer[G::index(x, y)] = palette_[idx];
+    }
+  }
+}
+
+template <typename G>
+void FlowFieldSceneT<G>::fadeTrails() {
+  uint16_t *buffer = sim_buffer_;
+  const uint32_t count = G::kPixels;
 
   for (uint32_t i = 0; i < count; ++i) {
     const uint16_t c = buffer[i];
@@ -230,25 +295,10 @@ void FlowFieldScene::render(Adafruit_Protomatter &matrix) {
     b = (uint8_t)((b * fade_factor_) >> 8);
     buffer[i] = (uint16_t)((r << 11) | (g << 5) | b);
   }
-
-  for (uint16_t i = 0; i < active_particles_; ++i) {
-    const int16_t x = (int16_t)(particles_[i].x_fp >> kFixedShift);
-    const int16_t y = (int16_t)(particles_[i].y_fp >> kFixedShift);
-    if ((uint16_t)x < kMatrixWidth && (uint16_t)y < kMatrixHeight) {
-      // Stable color based on particle index to prevent twinkling
-      const uint8_t base = (uint8_t)((i % 16) + palette_offset_);
-      const uint8_t count = (allowed_count_ == 0) ? 1 : allowed_count_;
-      const uint8_t mapped = allowed_indices_[base % count];
-      const uint8_t idx = mapped & 0x0F;
-      buffer[(y * kMatrixWidth) + x] = palette_[idx];
-    }
-  }
-
-  uint16_t *matrix_buffer = matrix.getBuffer();
-  memcpy(matrix_buffer, sim_buffer_, sizeof(sim_buffer_));
 }
 
-void FlowFieldScene::setWeather(const WeatherParams &params) {
+template <typename G>
+void FlowFieldSceneT<G>::setWeather(const WeatherParams &params) {
   weather_ = params;
   const float temp_f = params.valid ? params.temp_f : 70.0f;
   const float wind_mph = params.valid ? params.wind_speed_mph : 6.0f;
@@ -389,7 +439,8 @@ void FlowFieldScene::setWeather(const WeatherParams &params) {
   }
 }
 
-void FlowFieldScene::updatePalette(uint8_t warmth) {
+template <typename G>
+void FlowFieldSceneT<G>::updatePalette(uint8_t warmth) {
   // Much subtler tinting:
   // Warmth > 128 adds slight Red/Green (Warm)
   // Warmth < 128 adds slight Blue (Cool)
@@ -411,3 +462,4 @@ void FlowFieldScene::updatePalette(uint8_t warmth) {
   }
 }
 
+template class FlowFieldSceneT<PanelGeometry>;
@@ -2,26 +2,45 @@
 
 #include <Arduino.h>
 
+#include "Geometry.h"
+#include "Perf.h"
 #include "Scene.h"
 
-class FlowFieldScene : public Scene {
+struct FlowFieldVec2 {
+  int16_t x;
+  int16_t y;
+};
+
+// Instantiated for PanelGeometry in FlowFieldScene.cpp.
+template <typename G>
+class FlowFieldSceneT : public Scene {
 public:
-  struct Vec2 {
-    int16_t x;
-    int16_t y;
+  using Vec2 = FlowFieldVec2;
+
+  // State kept by SceneManager while the scene is not resident.
+  struct Resume {
+    uint32_t rng = 0x12345678;
   };
 
-  FlowFieldScene();
+  FlowFieldSceneT();
+  explicit FlowFieldSceneT(const Resume &resume);
+  Resume resume() const;
+
   void begin(Adafruit_Protomatter &matrix) override;
+  uint32_t warmupMs() const override;
+  void warmup(uint32_t dt_ms) override;
   void update(uint32_t dt_ms) override;
-  void render(Adafruit_Protomatter &matrix) override;
+  void render(RenderTarget &target) override;
   void setWeather(const WeatherParams &params) override;
 
 private:
-  static constexpr uint8_t kFieldCols = 16;
-  static constexpr uint8_t kFieldRows = 8;
+  // One flow direction per 4x4 pixel cell.
+  static constexpr uint8_t kFieldCellShift = 2;
+  static constexpr uint16_t kFieldCols = G::kWidth >> kFieldCellShift;
+  static constexpr uint16_t kFieldRows = G::kHeight >> kFieldCellShift;
   static constexpr uint16_t kFieldSize = kFieldCols * kFieldRows;
-  static constexpr uint16_t kParticleCount = 512;
+  // 512 particles per 64x32 of panel area.
+  static constexpr uint16_t kParticleCount = (uint16_t)(G::kPixels / 4);
   static constexpr uint8_t kFixedShift = 8;
   static constexpr int32_t kFixedOne = 1 << kFixedShift;
   static constexpr int16_t kParticleSpeed = 40; // pixels per second
@@ -29,6 +48,8 @@ private:
   static constexpr uint8_t kFadeFactor = 248; // 0-255
   static constexpr uint32_t kDriftIntervalMs = 80;
   static constexpr uint16_t kMinParticles = kParticleCount / 3;
+  // Trails reach their steady length after ~1/(1 - fade) frames.
+  static constexpr uint32_t kWarmupMs = 1500;
 
   struct Particle {
     int32_t x_fp;
@@ -40,6 +61,9 @@ private:
   static uint32_t nextRand(uint32_t &state);
   static Vec2 direction(uint8_t idx);
   void updatePalette(uint8_t warmth);
+  HOT_KERNEL void advanceParticles(uint32_t dt_ms);
+  HOT_KERNEL void fadeTrails();
+  void drawTrails();
 
   uint32_t rng_;
   uint32_t field_accum_ms_;
@@ -68,6 +92,8 @@ private:
 
   uint8_t field_[kFieldSize];
   Particle particles_[kParticleCount];
-  uint16_t sim_buffer_[64 * 32];
+  uint16_t sim_buffer_[G::kPixels];
   WeatherParams weather_;
 };
+
+using FlowFieldScene = FlowFieldSceneT<PanelGeometry>;
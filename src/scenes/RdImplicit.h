@@ -0,0 +1,198 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+
+#include "scenes/RdKernels.h"
+
+// Gray-Scott step for float cells that stays stable at time steps many times
+// what the explicit kernels allow, so a frame needs a few steps instead of
+// twenty. One step is split into
+//   - advection: the wind is uniform, so semi-Lagrangian advection is a
+//     shift of the whole field, done along rows and then columns with
+//     linear interpolation (a convex blend, stable at any wind);
+//   - reaction: the linear feed and kill terms implicit, uvv explicit;
+//   - diffusion: backward Euler along rows, then along columns (ADI), each
+//     an exact periodic tridiagonal solve.
+// The 9-point Laplacian of the explicit kernels is 0.3 * del^2 for smooth
+// fields, so the solves use 0.3 * diff. Cells use the HaloGeometry<Grid>
+// layout of the explicit kernels; the halo is left stale, as the explicit
+// kernels refresh it before reading.
+namespace RdImplicit {
+
+template <typename Grid>
+struct Scratch {
+  static constexpr int kLine = Grid::kWidth > Grid::kHeight ? Grid::kWidth : Grid::kHeight;
+  float line[kLine];
+};
+
+// Fraction of a cell in a shift of `shift` cells.
+inline float shiftFraction(float shift) {
+  return shift - floorf(shift);
+}
+
+// Linear interpolation across a fraction f of a cell spreads a field like
+// diffusion with a * 2 = f (1 - f); the solves take that much off theirs.
+inline float shiftSpread(float shift) {
+  const float f = shiftFraction(shift);
+  return 0.5f * f * (1.0f - f);
+}
+
+// Moves a periodic line of `n` cells, `stride` apart, by `shift` cells:
+// cell i takes the value from i - shift.
+inline void shiftLine(float *cells, int n, int stride, float shift, float *scratch) {
+  const float frac = shiftFraction(shift);
+  int whole = (int)floorf(shift) % n;
+  if (whole < 0) whole += n;
+
+  for (int i = 0; i < n; ++i) {
+    scratch[i] = cells[i * stride];
+  }
+  for (int i = 0; i < n; ++i) {
+    int j = i - whole;
+    if (j < 0) j += n;
+    const int k = j == 0 ? n - 1 : j - 1;
+    cells[i * stride] = scratch[j] + frac * (scratch[k] - scratch[j]);
+  }
+}
+
+// Solves (1 + 2a) x_i - a (x_{i-1} + x_{i+1}) = b_i on a periodic line. The
+// circulant matrix factors as (a / r)(1 - r S)(1 - r S^T), r being the
+// root below 1 of a r^2 - (1 + 2a) r + a = 0, so the solve is a forward and
+// a backward first-order recursion. Each recursion starts from a state run
+// once around the line, which is exact to r^n.
+struct LineSolver {
+  float r;
+  float gain; // r / a
+
+  static LineSolver make(float a) {
+    const float b = 1.0f + 2.0f * a;
+    const float root = b + sqrtf(b * b - 4.0f * a * a);
+    return LineSolver{2.0f * a / root, 2.0f / root};
+  }
+};
+
+// In place.
+inline void solveLine(float *cells, int n, int stride, const LineSolver &solver) {
+  const float r = solver.r;
+  const float gain = solver.gain;
+  float s = 0.0f;
+  for (int i = 0; i < n; ++i) {
+    s = gain * cells[i * stride] + r * s;
+  }
+  for (int i = 0; i < n; ++i) {
+    s = gain * cells[i * stride] + r * s;
+    cells[i * stride] = s;
+  }
+  s = 0.0f;
+  for (int i = n - 1; i >= 0; --i) {
+    s = cells[i * stride] + r * s;
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    s = cells[i * stride] + r * s;
+    cells[i * stride] = s;
+  }
+}
+
+// Reaction over `dt`. Final = true is the step's last pass: it takes the
+// noise kick and hands v to the tile stats and `emit`.
+template <typename Grid, bool Final, typename Emit>
+HOT_KERNEL void react(const RdKernels::StepParams &p, float dt, float *u, float *v,
+                      RdKernels::Tiles<Grid, float> &tiles, const Emit &emit) {
+  using Halo = HaloGeometry<Grid>;
+  using TileMap = RdKernels::Tiles<Grid, float>;
+  const float inv_height = 1.0f / Grid::kHeight;
+  const float feed_dt = p.feed * dt;
+  const float u_div = 1.0f / (1.0f + feed_dt);
+
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    const float norm_y = (float)y * inv_height;
+    const float local_kill = p.kill + (0.003f - (norm_y * 0.006f));
+    const float v_div = 1.0f / (1.0f + (p.feed + local_kill) * dt);
+    float *u_row = u + Halo::index(0, y);
+    float *v_row = v + Halo::index(0, y);
+    if (Final) {
+      tiles.resetRow(y);
+    }
+
+    for (int x = 0; x < Grid::kWidth; ++x) {
+      const float u_val = u_row[x];
+      const float v_val = v_row[x];
+      const float uvv = u_val * v_val * v_val;
+
+      float nu = (u_val + (feed_dt - uvv * dt)) * u_div;
+      float nv_num = v_val + uvv * dt;
+      if (Final && (Grid::index(x, y) & 0x7F) == 0) {
+        nv_num += ((float)random(100) - 50.0f) * 0.0001f * p.dt;
+      }
+      float nv = nv_num * v_div;
+
+      if (nu < 0.0f) nu = 0.0f;
+      else if (nu > 1.0f) nu = 1.0f;
+
+      if (nv < 0.0f) nv = 0.0f;
+      else if (nv > 1.0f) nv = 1.0f;
+
+      u_row[x] = nu;
+      v_row[x] = nv;
+      if (Final) {
+        tiles.stats[(y >> TileMap::kShift) * TileMap::kCols + (x >> TileMap::kShift)].addV(nv);
+        emit(x, y, nv);
+      }
+    }
+  }
+}
+
+template <typename Grid>
+void advect(const RdKernels::StepParams &p, float *field, Scratch<Grid> &scratch) {
+  using Halo = HaloGeometry<Grid>;
+  const float shift_x = p.wind_x * p.dt;
+  const float shift_y = p.wind_y * p.dt;
+  if (shift_x != 0.0f) {
+    for (int y = 0; y < Grid::kHeight; ++y) {
+      shiftLine(field + Halo::index(0, y), Grid::kWidth, 1, shift_x, scratch.line);
+    }
+  }
+  if (shift_y != 0.0f) {
+    for (int x = 0; x < Grid::kWidth; ++x) {
+      shiftLine(field + Halo::index(x, 0), Grid::kHeight, Halo::kStride, shift_y, scratch.line);
+    }
+  }
+}
+
+inline LineSolver diffusionSolver(float diff, float dt, float shift) {
+  const float a = 0.3f * diff * dt - shiftSpread(shift);
+  return LineSolver::make(a > 0.0f ? a : 0.0f);
+}
+
+// Rows, then columns.
+template <typename Grid>
+void diffuse(const RdKernels::StepParams &p, float *field, float diff) {
+  using Halo = HaloGeometry<Grid>;
+  const LineSolver rows = diffusionSolver(diff, p.dt, p.wind_x * p.dt);
+  const LineSolver columns = diffusionSolver(diff, p.dt, p.wind_y * p.dt);
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    solveLine(field + Halo::index(0, y), Grid::kWidth, 1, rows);
+  }
+  for (int x = 0; x < Grid::kWidth; ++x) {
+    solveLine(field + Halo::index(x, 0), Grid::kHeight, Halo::kStride, columns);
+  }
+}
+
+// One step of p.dt, as half a reaction step, the transport (advection and
+// diffusion) over p.dt, then the other half (Strang splitting). Tiles only
+// receive the v figures the health check reads: nothing here plans them,
+// so every tile stays awake and every cell is recomputed.
+template <typename Grid, typename Emit>
+void step(const RdKernels::StepParams &p, float *u, float *v, Scratch<Grid> &scratch,
+          RdKernels::Tiles<Grid, float> &tiles, const Emit &emit) {
+  const float half_dt = 0.5f * p.dt;
+  react<Grid, false>(p, half_dt, u, v, tiles, RdKernels::NoEmit());
+  advect(p, u, scratch);
+  advect(p, v, scratch);
+  diffuse<Grid>(p, u, p.diff_u);
+  diffuse<Grid>(p, v, p.diff_v);
+  react<Grid, true>(p, half_dt, u, v, tiles, emit);
+}
+
+} // namespace RdImplicit
@@ -0,0 +1,744 @@
+#pragma once
+
+#include <Arduino.h>
+#include <math.h>
+
+#include "AppConfig.h"
+#include "Dsp.h"
+#include "Geometry.h"
+#include "Perf.h"
+
+// Cell formats for the Gray-Scott solver. APP_RD_FIXED_POINT picks one at
+// compile time; both render through the same 0-255 palette index.
+struct RdFloatCells {
+  using Cell = float;
+  static constexpr Cell fromFloat(float v) { return v; }
+  static constexpr float toFloat(Cell c) { return c; }
+  static inline uint8_t paletteIndex(Cell c) {
+    // Multiplier keeps the pattern off saturation so movement stays visible
+    const int idx = (int)(c * 600.0f);
+    return (uint8_t)(idx < 0 ? 0 : (idx > 255 ? 255 : idx));
+  }
+};
+
+// Q1.14 in int16_t: 1.0 is 16384, leaving headroom for stencil sums.
+struct RdQ14Cells {
+  using Cell = int16_t;
+  static constexpr uint8_t kShift = 14;
+  static constexpr int32_t kOne = 1 << kShift;
+  static constexpr Cell fromFloat(float v) { return (Cell)(v * (float)kOne + 0.5f); }
+  static constexpr float toFloat(Cell c) { return (float)c / (float)kOne; }
+  static inline uint8_t paletteIndex(Cell c) {
+    const int32_t idx = ((int32_t)c * 600) >> kShift;
+    return (uint8_t)(idx < 0 ? 0 : (idx > 255 ? 255 : idx));
+  }
+};
+
+#if APP_RD_FIXED_POINT
+using RdCells = RdQ14Cells;
+#else
+using RdCells = RdFloatCells;
+#endif
+
+// Gray-Scott step kernels. One step updates the u/v grids in place; Grid
+// is the solver's Geometry and the grids are stored in HaloGeometry<Grid>
+// layout. A step refreshes the halo first, so cells written between steps
+// (seeds, rain) wrap like any other.
+//
+// The stencil needs the old values of rows y-1, y and y+1 while row y is
+// rewritten. Row y+1 is still untouched, so only two old rows are kept: a
+// RowRing holds the copies of rows y-1 and y, and the halo rows stand in
+// for the wrapped neighbours of the first and last rows.
+//
+// Only the 8x8 tiles flagged in Tiles::run are stepped; the rest keep their
+// values. Stepped tiles report how far their cells moved and the sum and
+// peak of v, so the scene never scans the grid itself.
+//
+// A step can also hand every cell's v to an emitter, emit(x, y, v), as it
+// is produced (calm tiles: their current v), so the scene can write its
+// frame from the last step of an update. Steps that render nothing pass
+// NoEmit and compile to the plain kernels.
+namespace RdKernels {
+
+struct StepParams {
+  float feed;
+  float kill;
+  float diff_u;
+  float diff_v;
+  float dt;
+  float wind_x;
+  float wind_y;
+};
+
+template <typename Grid, typename Cell>
+struct RowRing {
+  Cell u[2][HaloGeometry<Grid>::kStride];
+  Cell v[2][HaloGeometry<Grid>::kStride];
+};
+
+// One field's old rows around row y, from column 0, and where row y's new
+// values go.
+template <typename Cell>
+struct FieldRows {
+  const Cell *top;
+  const Cell *mid;
+  const Cell *bot;
+  Cell *out;
+};
+
+// Saves row y (halo cells included) into the ring before it is rewritten.
+template <typename Grid, typename Cell>
+inline FieldRows<Cell> beginRow(Cell *grid, Cell (&ring)[2][HaloGeometry<Grid>::kStride], int y) {
+  using Halo = HaloGeometry<Grid>;
+  Cell *row = grid + Halo::index(0, y);
+  Cell *saved = ring[y & 1];
+  memcpy(saved, row - 1, Halo::kStride * sizeof(Cell));
+  FieldRows<Cell> rows;
+  rows.top = y == 0 ? row - Halo::kStride : ring[(y - 1) & 1] + 1;
+  rows.mid = saved + 1;
+  rows.bot = row + Halo::kStride;
+  rows.out = row;
+  return rows;
+}
+
+struct NoEmit {
+  static constexpr bool kEnabled = false;
+  template <typename Cell>
+  void operator()(int x, int y, Cell v) const {
+    (void)x;
+    (void)y;
+    (void)v;
+  }
+};
+
+// Per-tile figures from the last step that ran the tile. Acc is float for
+// float cells and int for Q1.14 cells.
+template <typename Cell>
+struct TileStats {
+  using Acc = decltype(Cell{} + Cell{});
+  Acc v_sum;
+  Acc v_max;
+  Acc change; // Largest |new - old| of any cell's u or v
+
+  void reset() {
+    v_sum = 0;
+    v_max = 0;
+    change = 0;
+  }
+
+  // The v figures only, for steps that do not track change.
+  void addV(Acc v) {
+    v_sum += v;
+    if (v > v_max) v_max = v;
+  }
+
+  // `kicked`: the cell took the noise kick, which is not activity.
+  void add(Acc u_old, Acc u_new, Acc v_old, Acc v_new, bool kicked) {
+    addV(v_new);
+    const Acc du = u_new > u_old ? u_new - u_old : u_old - u_new;
+    if (du > change) change = du;
+    if (!kicked) {
+      const Acc dv = v_new > v_old ? v_new - v_old : v_old - v_new;
+      if (dv > change) change = dv;
+    }
+  }
+};
+
+// Which tiles the next step runs. After each step plan() keeps a tile
+// running while it or one of its eight (wrapped) neighbours is busy, and
+// lets calm tiles through once every `interval` steps. wake() forces a tile
+// in for the next step after an outside write.
+template <typename Grid, typename Cell>
+class Tiles {
+public:
+  static constexpr uint8_t kShift = 3;
+  static constexpr int kSize = 1 << kShift;
+  static constexpr int kCols = (Grid::kWidth + kSize - 1) >> kShift;
+  static constexpr int kRows = (Grid::kHeight + kSize - 1) >> kShift;
+  static constexpr int kCount = kCols * kRows;
+  using Stats = TileStats<Cell>;
+  using Acc = typename Stats::Acc;
+
+  Tiles(Acc calm, uint8_t interval) : calm_(calm), interval_(interval), phase_(0) {
+    for (int t = 0; t < kCount; ++t) {
+      stats[t].reset();
+    }
+    wakeAll();
+  }
+
+  uint8_t run[kCount];
+  Stats stats[kCount];
+
+  void wakeAll() { memset(run, 1, sizeof(run)); }
+
+  void wake(int x, int y) { run[(y >> kShift) * kCols + (x >> kShift)] = 1; }
+
+  void plan() {
+    uint8_t busy[kCount];
+    for (int t = 0; t < kCount; ++t) {
+      busy[t] = run[t] && stats[t].change > calm_;
+    }
+    if (++phase_ >= interval_) {
+      phase_ = 0;
+    }
+    for (int ty = 0; ty < kRows; ++ty) {
+      for (int tx = 0; tx < kCols; ++tx) {
+        uint8_t next = phase_ == 0;
+        for (int dy = -1; dy <= 1 && !next; ++dy) {
+          const int ny = (ty + dy + kRows) % kRows;
+          for (int dx = -1; dx <= 1; ++dx) {
+            next |= busy[ny * kCols + (tx + dx + kCols) % kCols];
+          }
+        }
+        run[ty * kCols + tx] = next;
+      }
+    }
+  }
+
+  // Over the whole grid; tiles that sat out still hold their last figures.
+  Acc vSum() const {
+    Acc sum = 0;
+    for (int t = 0; t < kCount; ++t) {
+      sum += stats[t].v_sum;
+    }
+    return sum;
+  }
+
+  Acc vMax() const {
+    Acc peak = 0;
+    for (int t = 0; t < kCount; ++t) {
+      if (stats[t].v_max > peak) peak = stats[t].v_max;
+    }
+    return peak;
+  }
+
+  // Cell range [x0, x1) of tile column tx.
+  static int x0(int tx) { return tx << kShift; }
+  static int x1(int tx) {
+    return (tx + 1) * kSize < Grid::kWidth ? (tx + 1) * kSize : Grid::kWidth;
+  }
+
+  // Resets the figures of the tiles row y starts stepping.
+  void resetRow(int y) {
+    if ((y & (kSize - 1)) == 0) {
+      const int row = (y >> kShift) * kCols;
+      for (int tx = 0; tx < kCols; ++tx) {
+        if (run[row + tx]) stats[row + tx].reset();
+      }
+    }
+  }
+
+private:
+  Acc calm_;
+  uint8_t interval_;
+  uint8_t phase_;
+};
+
+// A 3x3 neighbourhood sliding along a row: advance() loads the column right
+// of the centre, shift() moves the window on by one cell. Every cell is
+// loaded once per pass, and the Laplacian and the gradients share it.
+template <typename T>
+struct Window {
+  T tl, t, tr;
+  T l, c, r;
+  T bl, b, br;
+
+  template <typename Cell>
+  void start(const FieldRows<Cell> &rows, int x) {
+    tl = rows.top[x - 1];
+    t = rows.top[x];
+    l = rows.mid[x - 1];
+    c = rows.mid[x];
+    bl = rows.bot[x - 1];
+    b = rows.bot[x];
+  }
+
+  template <typename Cell>
+  void advance(const FieldRows<Cell> &rows, int x) {
+    tr = rows.top[x + 1];
+    r = rows.mid[x + 1];
+    br = rows.bot[x + 1];
+  }
+
+  void shift() {
+    tl = t;
+    t = tr;
+    l = c;
+    c = r;
+    bl = b;
+    b = br;
+  }
+};
+
+// Simple 3x3 Laplacian kernel
+inline float laplacian(const Window<float> &w) {
+  float sum = 0.0f;
+
+  // Center
+  sum += w.c * -1.0f;
+
+  // Orthogonal neighbors (0.2)
+  sum += w.l * 0.2f;
+  sum += w.r * 0.2f;
+  sum += w.t * 0.2f;
+  sum += w.b * 0.2f;
+
+  // Diagonal neighbors (0.05)
+  sum += w.tl * 0.05f;
+  sum += w.tr * 0.05f;
+  sum += w.bl * 0.05f;
+  sum += w.br * 0.05f;
+
+  return sum;
+}
+
+// Wind = false drops the advection terms, which are exactly zero then.
+template <typename Grid, bool Wind, typename Emit>
+HOT_KERNEL void stepRows(const StepParams &p, float *u, float *v, RowRing<Grid, float> &ring,
+                         Tiles<Grid, float> &tiles, const Emit &emit) {
+  using TileMap = Tiles<Grid, float>;
+  const float inv_height = 1.0f / Grid::kHeight;
+
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    float norm_y = (float)y * inv_height;
+    float local_kill = p.kill + (0.003f - (norm_y * 0.006f));
+
+    const FieldRows<float> ru = beginRow<Grid>(u, ring.u, y);
+    const FieldRows<float> rv = beginRow<Grid>(v, ring.v, y);
+
+    const int tile_row = (y >> TileMap::kShift) * TileMap::kCols;
+    tiles.resetRow(y);
+
+    for (int tx = 0; tx < TileMap::kCols; ++tx) {
+      if (!tiles.run[tile_row + tx]) {
+        if (Emit::kEnabled) {
+          for (int x = TileMap::x0(tx); x < TileMap::x1(tx); ++x) {
+            emit(x, y, rv.mid[x]);
+          }
+        }
+        continue;
+      }
+      typename TileMap::Stats &stats = tiles.stats[tile_row + tx];
+      const int x1 = TileMap::x1(tx);
+      int x = TileMap::x0(tx);
+
+      Window<float> wu;
+      Window<float> wv;
+      wu.start(ru, x);
+      wv.start(rv, x);
+
+      for (; x < x1; ++x) {
+        wu.advance(ru, x);
+        wv.advance(rv, x);
+
+        float u_val = wu.c;
+        float v_val = wv.c;
+
+        float uvv = u_val * v_val * v_val;
+        float lap_u = laplacian(wu);
+        float lap_v = laplacian(wv);
+
+        float du = (p.diff_u * lap_u) - uvv + (p.feed * (1.0f - u_val));
+        float dv = (p.diff_v * lap_v) + uvv - ((p.feed + local_kill) * v_val);
+
+        const int i = Grid::index(x, y);
+        const bool kicked = (i & 0x7F) == 0;
+        if (kicked) {
+          dv += ((float)random(100) - 50.0f) * 0.0001f;
+        }
+
+        if (Wind) {
+          // Advection: central gradients
+          float grad_u_x = (wu.r - wu.l) * 0.5f;
+          float grad_u_y = (wu.b - wu.t) * 0.5f;
+          float grad_v_x = (wv.r - wv.l) * 0.5f;
+          float grad_v_y = (wv.b - wv.t) * 0.5f;
+
+          du += -(p.wind_x * grad_u_x + p.wind_y * grad_u_y);
+          dv += -(p.wind_x * grad_v_x + p.wind_y * grad_v_y);
+        }
+
+        float nu = u_val + (du * p.dt);
+        float nv = v_val + (dv * p.dt);
+
+        if (nu < 0.0f) nu = 0.0f;
+        else if (nu > 1.0f) nu = 1.0f;
+
+        if (nv < 0.0f) nv = 0.0f;
+        else if (nv > 1.0f) nv = 1.0f;
+
+        ru.out[x] = nu;
+        rv.out[x] = nv;
+        stats.add(u_val, nu, v_val, nv, kicked);
+        emit(x, y, nv);
+
+        wu.shift();
+        wv.shift();
+      }
+    }
+  }
+}
+
+// Q1.14 solvers. Every term of the float solver is pre-multiplied by dt and
+// turned into a Q15 coefficient once per step, so a cell costs integer
+// multiply-adds into one accumulator, rounded once. The Laplacian is summed
+// as differences from the centre, the orthogonal and the diagonal pairs
+// each halved so the sums stay within 16 bits, and weighted 0.4 and 0.1
+// (the float stencil's 0.2 and 0.05, doubled back). The scalar kernel and
+// the DSP kernel below do exactly this arithmetic, so their results agree
+// bit-for-bit, on the M4 and with the portable Dsp:: build alike.
+inline int16_t q15(float v) {
+  const float scaled = v * 32768.0f + (v < 0.0f ? -0.5f : 0.5f);
+  return (int16_t)(scaled > 32767.0f ? 32767 : (scaled < -32768.0f ? -32768 : (int32_t)scaled));
+}
+
+// The kill bias at the top row; it falls to minus this at the bottom.
+constexpr float kRowKillBias = 0.003f;
+
+inline float rowKillBias(int y, int height) {
+  return kRowKillBias - ((float)y / height) * (2.0f * kRowKillBias);
+}
+
+// Whether the Q1.14 kernels can take `p`. Every coefficient must be below
+// 1 (q15() would saturate it and quietly change the equation), and the
+// accumulator must stay inside int32 at the extreme stencil values: halved
+// sums up to one kOne, gradients, uvv and 1 - u up to half that.
+inline bool fitsQ15(const StepParams &p) {
+  constexpr float kMax = 32767.0f / 32768.0f;
+  const float diff = fmaxf(fabsf(p.diff_u), fabsf(p.diff_v)) * p.dt;
+  const float wind_x = fabsf(p.wind_x) * 0.5f * p.dt;
+  const float wind_y = fabsf(p.wind_y) * 0.5f * p.dt;
+  const float feed = fabsf(p.feed) * p.dt;
+  const float decay = (fabsf(p.feed + p.kill) + kRowKillBias) * p.dt;
+  if (!(p.dt >= 0.0f) || 0.4f * diff >= kMax || wind_x >= kMax || wind_y >= kMax ||
+      p.dt >= kMax || feed >= kMax || decay >= kMax) {
+    return false;
+  }
+  // In units of 2^30; 2 is the int32 limit, less a margin for the rounding
+  // and noise terms.
+  return 0.5f * diff + 0.5f * (wind_x + wind_y + p.dt + fmaxf(feed, decay)) < 1.99f;
+}
+
+// Longest step the Q1.14 kernels take: dt is itself a coefficient (on uvv),
+// so it must stay below 1 whatever the other rates.
+constexpr float kMaxQ14Dt = 0.99f;
+
+struct Q14Coeffs {
+  int16_t lap_u[2];   // (0.4, 0.1) * diff_u * dt on the halved sums
+  int16_t lap_v[2];
+  int16_t wind[2];    // -(wind_x, wind_y) * 0.5 * dt on (r - l, b - t)
+  int16_t react_u[2]; // (-dt, feed * dt) on (uvv, 1 - u)
+  int16_t dt;         // on uvv, for v; the row's decay comes from decayQ15()
+  int32_t noise;      // per unit of random(100) - 50, Q15-scaled Q14
+  // Rounding plus the mean quarter-LSB the halving drops.
+  int32_t round_u;
+  int32_t round_v;
+};
+
+inline int32_t halvingBias(const int16_t (&lap)[2]) {
+  return (1 << 14) + ((lap[0] + lap[1]) >> 2);
+}
+
+inline Q14Coeffs q14Coeffs(const StepParams &p) {
+  Q14Coeffs k;
+  k.lap_u[0] = q15(0.4f * p.diff_u * p.dt);
+  k.lap_u[1] = q15(0.1f * p.diff_u * p.dt);
+  k.lap_v[0] = q15(0.4f * p.diff_v * p.dt);
+  k.lap_v[1] = q15(0.1f * p.diff_v * p.dt);
+  k.wind[0] = q15(-p.wind_x * 0.5f * p.dt);
+  k.wind[1] = q15(-p.wind_y * 0.5f * p.dt);
+  k.react_u[0] = q15(-p.dt);
+  k.react_u[1] = q15(p.feed * p.dt);
+  k.dt = q15(p.dt);
+  k.noise = (int32_t)(0.0001f * p.dt * (float)RdQ14Cells::kOne * 32768.0f + 0.5f);
+  k.round_u = halvingBias(k.lap_u);
+  k.round_v = halvingBias(k.lap_v);
+  return k;
+}
+
+// -(feed + kill + row bias) * dt on v.
+inline int16_t decayQ15(const StepParams &p, int y, int height) {
+  return q15(-(p.feed + p.kill + rowKillBias(y, height)) * p.dt);
+}
+
+// Half the summed differences of two opposite pairs of neighbours from the
+// centre, each pair's sum saturated to 16 bits as the packed adds do.
+inline int32_t halfSum(int32_t a, int32_t b, int32_t c, int32_t d, int32_t centre) {
+  return (Dsp::ssat<16>(a - centre + b - centre) + Dsp::ssat<16>(c - centre + d - centre)) >> 1;
+}
+
+inline int32_t q14Update(int32_t value, int32_t acc, int32_t round) {
+  const int32_t next = value + ((acc + round) >> 15);
+  const int32_t sat = Dsp::usat<15>(next);
+  return sat > RdQ14Cells::kOne ? RdQ14Cells::kOne : sat;
+}
+
+inline int32_t q14Uvv(int32_t u, int32_t v) {
+  constexpr uint8_t kShift = RdQ14Cells::kShift;
+  return ((((u * v) >> kShift) * v) + (1 << (kShift - 1))) >> kShift;
+}
+
+template <typename Grid, bool Wind, typename Emit>
+HOT_KERNEL void stepRows(const StepParams &p, int16_t *u, int16_t *v,
+                         RowRing<Grid, int16_t> &ring, Tiles<Grid, int16_t> &tiles,
+                         const Emit &emit) {
+  using TileMap = Tiles<Grid, int16_t>;
+  constexpr int32_t kOne = RdQ14Cells::kOne;
+  const Q14Coeffs k = q14Coeffs(p);
+
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    const int32_t decay = decayQ15(p, y, Grid::kHeight);
+
+    const FieldRows<int16_t> ru = beginRow<Grid>(u, ring.u, y);
+    const FieldRows<int16_t> rv = beginRow<Grid>(v, ring.v, y);
+    const int tile_row = (y >> TileMap::kShift) * TileMap::kCols;
+    tiles.resetRow(y);
+
+    for (int tx = 0; tx < TileMap::kCols; ++tx) {
+      if (!tiles.run[tile_row + tx]) {
+        if (Emit::kEnabled) {
+          for (int x = TileMap::x0(tx); x < TileMap::x1(tx); ++x) {
+            emit(x, y, rv.mid[x]);
+          }
+        }
+        continue;
+      }
+      typename TileMap::Stats &stats = tiles.stats[tile_row + tx];
+      const int x1 = TileMap::x1(tx);
+      int x = TileMap::x0(tx);
+
+      Window<int32_t> wu;
+      Window<int32_t> wv;
+      wu.start(ru, x);
+      wv.start(rv, x);
+
+      for (; x < x1; ++x) {
+        wu.advance(ru, x);
+        wv.advance(rv, x);
+
+        const int32_t u_val = wu.c;
+        const int32_t v_val = wv.c;
+        const int32_t uvv = q14Uvv(u_val, v_val);
+
+        int32_t acc_u = halfSum(wu.l, wu.r, wu.t, wu.b, u_val) * k.lap_u[0] +
+                        halfSum(wu.tl, wu.tr, wu.bl, wu.br, u_val) * k.lap_u[1];
+        int32_t acc_v = halfSum(wv.l, wv.r, wv.t, wv.b, v_val) * k.lap_v[0] +
+                        halfSum(wv.tl, wv.tr, wv.bl, wv.br, v_val) * k.lap_v[1];
+        if (Wind) {
+          acc_u += (wu.r - wu.l) * k.wind[0] + (wu.b - wu.t) * k.wind[1];
+          acc_v += (wv.r - wv.l) * k.wind[0] + (wv.b - wv.t) * k.wind[1];
+        }
+        acc_u += uvv * k.react_u[0] + (kOne - u_val) * k.react_u[1];
+        acc_v += uvv * k.dt + v_val * decay;
+
+        const bool kicked = (Grid::index(x, y) & 0x7F) == 0;
+        if (kicked) {
+          acc_v += ((int32_t)random(100) - 50) * k.noise;
+        }
+
+        const int16_t nu = (int16_t)q14Update(u_val, acc_u, k.round_u);
+        const int16_t nv = (int16_t)q14Update(v_val, acc_v, k.round_v);
+        ru.out[x] = nu;
+        rv.out[x] = nv;
+        stats.add(u_val, nu, v_val, nv, kicked);
+        emit(x, y, nv);
+
+        wu.shift();
+        wv.shift();
+      }
+    }
+  }
+}
+
+// The Q1.14 step on the Cortex-M4 DSP extension, two horizontally adjacent
+// cells per pass. Stencil sums run on packed halfwords (both cells at once);
+// each cell's weighted terms then go through dual multiply-accumulates with
+// the Q15 coefficient pairs.
+
+// Left, centre and right neighbour pairs of cells (x, x + 1).
+struct Pairs {
+  uint32_t l;
+  uint32_t m;
+  uint32_t r;
+};
+
+inline Pairs loadPairs(const int16_t *row, int x) {
+  return Pairs{Dsp::load2(row + x - 1), Dsp::load2(row + x), Dsp::load2(row + x + 1)};
+}
+
+// One field's stencil terms for both cells: half the summed orthogonal and
+// diagonal differences from the centre, and the doubled central gradients
+// (r - l, b - t). Differences keep every lane inside 16 bits.
+struct Stencil {
+  uint32_t orth;
+  uint32_t diag;
+  uint32_t gx;
+  uint32_t gy;
+};
+
+inline Stencil stencil(const Pairs &t, const Pairs &m, const Pairs &b) {
+  const uint32_t c = m.m;
+  const uint32_t orth = Dsp::shadd16(Dsp::qadd16(Dsp::qsub16(m.l, c), Dsp::qsub16(m.r, c)),
+                                     Dsp::qadd16(Dsp::qsub16(t.m, c), Dsp::qsub16(b.m, c)));
+  const uint32_t diag = Dsp::shadd16(Dsp::qadd16(Dsp::qsub16(t.l, c), Dsp::qsub16(t.r, c)),
+                                     Dsp::qadd16(Dsp::qsub16(b.l, c), Dsp::qsub16(b.r, c)));
+  return Stencil{orth, diag, Dsp::qsub16(m.r, m.l), Dsp::qsub16(b.m, t.m)};
+}
+
+// Q14Coeffs pairs packed for smlad.
+struct DspCoeffs {
+  uint32_t lap_u;
+  uint32_t lap_v;
+  uint32_t wind;
+  uint32_t react_u;
+};
+
+inline DspCoeffs dspCoeffs(const Q14Coeffs &k) {
+  return DspCoeffs{Dsp::pack(k.lap_u[0], k.lap_u[1]), Dsp::pack(k.lap_v[0], k.lap_v[1]),
+                   Dsp::pack(k.wind[0], k.wind[1]), Dsp::pack(k.react_u[0], k.react_u[1])};
+}
+
+// `i` is the unpadded index of the left cell; it paces the noise.
+template <bool Wind, typename Emit>
+inline void stepPairDsp(const Q14Coeffs &k, const DspCoeffs &kp, uint32_t react_v,
+                        const FieldRows<int16_t> &ru, const FieldRows<int16_t> &rv, int x, int y,
+                        int i, TileStats<int16_t> &stats, const Emit &emit) {
+  const Pairs ut = loadPairs(ru.top, x);
+  const Pairs um = loadPairs(ru.mid, x);
+  const Pairs ub = loadPairs(ru.bot, x);
+  const Pairs vt = loadPairs(rv.top, x);
+  const Pairs vm = loadPairs(rv.mid, x);
+  const Pairs vb = loadPairs(rv.bot, x);
+  const Stencil su = stencil(ut, um, ub);
+  const Stencil sv = stencil(vt, vm, vb);
+
+  int32_t out_u[2];
+  int32_t out_v[2];
+  for (uint8_t lane = 0; lane < 2; ++lane) {
+    const int32_t u_val = lane ? Dsp::hi(um.m) : Dsp::lo(um.m);
+    const int32_t v_val = lane ? Dsp::hi(vm.m) : Dsp::lo(vm.m);
+    const int32_t uvv = q14Uvv(u_val, v_val);
+
+    // Lane-select each stencil vector into one (term, term) pair.
+    const uint32_t lap_u = lane ? Dsp::pack(Dsp::hi(su.orth), Dsp::hi(su.diag))
+                                : Dsp::pack(Dsp::lo(su.orth), Dsp::lo(su.diag));
+    const uint32_t lap_v = lane ? Dsp::pack(Dsp::hi(sv.orth), Dsp::hi(sv.diag))
+                                : Dsp::pack(Dsp::lo(sv.orth), Dsp::lo(sv.diag));
+
+    int32_t acc_u = Dsp::smlad(lap_u, kp.lap_u, 0);
+    int32_t acc_v = Dsp::smlad(lap_v, kp.lap_v, 0);
+    if (Wind) {
+      const uint32_t grad_u = lane ? Dsp::pack(Dsp::hi(su.gx), Dsp::hi(su.gy))
+                                   : Dsp::pack(Dsp::lo(su.gx), Dsp::lo(su.gy));
+      const uint32_t grad_v = lane ? Dsp::pack(Dsp::hi(sv.gx), Dsp::hi(sv.gy))
+                                   : Dsp::pack(Dsp::lo(sv.gx), Dsp::lo(sv.gy));
+      acc_u = Dsp::smlad(grad_u, kp.wind, acc_u);
+      acc_v = Dsp::smlad(grad_v, kp.wind, acc_v);
+    }
+    acc_u = Dsp::smlad(Dsp::pack(uvv, RdQ14Cells::kOne - u_val), kp.react_u, acc_u);
+    acc_v = Dsp::smlad(Dsp::pack(uvv, v_val), react_v, acc_v);
+    if (lane == 0 && ((i & 0x7F) == 0)) {
+      acc_v += ((int32_t)random(100) - 50) * k.noise;
+    }
+
+    out_u[lane] = q14Update(u_val, acc_u, k.round_u);
+    out_v[lane] = q14Update(v_val, acc_v, k.round_v);
+    stats.add(u_val, out_u[lane], v_val, out_v[lane], lane == 0 && ((i & 0x7F) == 0));
+    emit(x + lane, y, (int16_t)out_v[lane]);
+  }
+  Dsp::store2(ru.out + x, Dsp::pack(out_u[0], out_u[1]));
+  Dsp::store2(rv.out + x, Dsp::pack(out_v[0], out_v[1]));
+}
+
+template <typename Grid, bool Wind, typename Emit>
+HOT_KERNEL void stepRowsDsp(const StepParams &p, int16_t *u, int16_t *v,
+                            RowRing<Grid, int16_t> &ring, Tiles<Grid, int16_t> &tiles,
+                            const Emit &emit) {
+  using TileMap = Tiles<Grid, int16_t>;
+  static_assert(Grid::kWidth % 2 == 0, "DSP kernel steps cell pairs");
+  const Q14Coeffs k = q14Coeffs(p);
+  const DspCoeffs kp = dspCoeffs(k);
+
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    const uint32_t react_v = Dsp::pack(k.dt, decayQ15(p, y, Grid::kHeight));
+    const FieldRows<int16_t> ru = beginRow<Grid>(u, ring.u, y);
+    const FieldRows<int16_t> rv = beginRow<Grid>(v, ring.v, y);
+    const int i = Grid::index(0, y);
+    const int tile_row = (y >> TileMap::kShift) * TileMap::kCols;
+    tiles.resetRow(y);
+
+    for (int tx = 0; tx < TileMap::kCols; ++tx) {
+      if (!tiles.run[tile_row + tx]) {
+        if (Emit::kEnabled) {
+          for (int x = TileMap::x0(tx); x < TileMap::x1(tx); ++x) {
+            emit(x, y, rv.mid[x]);
+          }
+        }
+        continue;
+      }
+      typename TileMap::Stats &stats = tiles.stats[tile_row + tx];
+      for (int x = TileMap::x0(tx); x < TileMap::x1(tx); x += 2) {
+        stepPairDsp<Wind>(k, kp, react_v, ru, rv, x, y, i + x, stats, emit);
+      }
+    }
+  }
+}
+
+// Whether the kernels for this cell format can take `p`.
+inline bool fits(const StepParams &, const float *) {
+  return true;
+}
+
+inline bool fits(const StepParams &p, const int16_t *) {
+  return fitsQ15(p);
+}
+
+// Entry points: refresh the halo, run the kernel specialised for whether
+// there is wind to advect with, then plan the next step's tiles. A step
+// whose parameters the cell format cannot represent (fits()) is rejected:
+// the fields are left as they are.
+template <typename Grid, typename Cell, typename Emit>
+void stepGrid(const StepParams &p, Cell *u, Cell *v, RowRing<Grid, Cell> &ring,
+              Tiles<Grid, Cell> &tiles, const Emit &emit) {
+  if (!fits(p, u)) {
+    return;
+  }
+  HaloGeometry<Grid>::refresh(u);
+  HaloGeometry<Grid>::refresh(v);
+  if (p.wind_x != 0.0f || p.wind_y != 0.0f) {
+    stepRows<Grid, true>(p, u, v, ring, tiles, emit);
+  } else {
+    stepRows<Grid, false>(p, u, v, ring, tiles, emit);
+  }
+  tiles.plan();
+}
+
+template <typename Grid, typename Cell>
+void stepGrid(const StepParams &p, Cell *u, Cell *v, RowRing<Grid, Cell> &ring,
+              Tiles<Grid, Cell> &tiles) {
+  stepGrid(p, u, v, ring, tiles, NoEmit());
+}
+
+template <typename Grid, typename Emit>
+void stepGridDsp(const StepParams &p, int16_t *u, int16_t *v, RowRing<Grid, int16_t> &ring,
+                 Tiles<Grid, int16_t> &tiles, const Emit &emit) {
+  if (!fitsQ15(p)) {
+    return;
+  }
+  HaloGeometry<Grid>::refresh(u);
+  HaloGeometry<Grid>::refresh(v);
+  if (p.wind_x != 0.0f || p.wind_y != 0.0f) {
+    stepRowsDsp<Grid, true>(p, u, v, ring, tiles, emit);
+  } else {
+    stepRowsDsp<Grid, false>(p, u, v, ring, tiles, emit);
+  }
+  tiles.plan();
+}
+
+template <typename Grid>
+void stepGridDsp(const StepParams &p, int16_t *u, int16_t *v, RowRing<Grid, int16_t> &ring,
+                 Tiles<Grid, int16_t> &tiles) {
+  stepGridDsp(p, u, v, ring, tiles, NoEmit());
+}
+
+} // namespace RdKernels
@@ -0,0 +1,344 @@
+#include "scenes/RdSnapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "QspiFlash.h"
+
+namespace RdSnapshot {
+namespace {
+constexpr uint32_t kMagic = 0x31534452; // "RDS1"
+constexpr uint16_t kVersion = 1;
+constexpr uint32_t kMaxRun = 130;
+constexpr uint32_t kMaxLiterals = 128;
+
+// Stored as is: target and host are both little-endian.
+struct Header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t width;
+  uint16_t height;
+  uint16_t reserved;
+  uint32_t seq;
+  uint32_t payload_bytes;
+  Params params;
+  uint32_t crc; // Payload, then this header with crc = 0
+};
+static_assert(sizeof(Header) == 48, "Snapshot header layout changed");
+
+uint32_t crc32(uint32_t crc, const uint8_t *data, uint32_t len) {
+  for (uint32_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (uint8_t bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+    }
+  }
+  return crc;
+}
+
+uint32_t headerCrc(uint32_t crc, Header header) {
+  header.crc = 0;
+  return ~crc32(crc, reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+}
+
+uint32_t rawBytes(const Field &field) {
+  return 2UL * field.width * field.height;
+}
+
+// Sized for the worst case, all literals.
+uint32_t slotBytes(const Field &field) {
+  const uint32_t raw = rawBytes(field);
+  const uint32_t bytes = QspiFlash::kPageBytes + raw + (raw + kMaxLiterals - 1) / kMaxLiterals;
+  return (bytes + QspiFlash::kSectorBytes - 1) / QspiFlash::kSectorBytes * QspiFlash::kSectorBytes;
+}
+
+uint16_t slotCount(const Field &field) {
+  return (uint16_t)(QspiFlash::size() / slotBytes(field));
+}
+
+void log(const Hooks &hooks, const char *line) {
+  if (hooks.log) {
+    hooks.log(line);
+  }
+}
+
+uint32_t now(const Hooks &hooks) {
+  return hooks.now_ms ? hooks.now_ms() : 0;
+}
+
+bool readHeader(const Field &field, uint16_t slot, Header &header) {
+  QspiFlash::read((uint32_t)slot * slotBytes(field), &header, sizeof(header));
+  return header.magic == kMagic && header.version == kVersion && header.width == field.width &&
+         header.height == field.height;
+}
+
+// The newest slot with a header for this grid and seq below `below`.
+bool newest(const Field &field, uint32_t below, uint16_t &slot, Header &header) {
+  bool found = false;
+  const uint16_t slots = slotCount(field);
+  for (uint16_t s = 0; s < slots; ++s) {
+    Header h;
+    if (readHeader(field, s, h) && h.seq < below && (!found || h.seq > header.seq)) {
+      found = true;
+      slot = s;
+      header = h;
+    }
+  }
+  return found;
+}
+
+Cell *cellAt(const Field &field, uint32_t pos) {
+  const uint32_t cells = (uint32_t)field.width * field.height;
+  Cell *grid = pos < cells ? field.u : field.v;
+  const uint32_t i = pos < cells ? pos : pos - cells;
+  return grid + field.index((int)(i % field.width), (int)(i / field.width));
+}
+
+uint8_t quantise(Cell cell) {
+  const float v = RdCells::toFloat(cell) * 255.0f + 0.5f;
+  return v <= 0.0f ? 0 : (v >= 255.0f ? 255 : (uint8_t)v);
+}
+
+// u then v, row by row, in payload order.
+void quantiseField(const Field &field, uint8_t *out) {
+  const Cell *const grids[] = {field.u, field.v};
+  for (const Cell *grid : grids) {
+    for (int y = 0; y < field.height; ++y) {
+      const Cell *row = grid + field.index(0, y);
+      for (int x = 0; x < field.width; ++x) {
+        *out++ = quantise(row[x]);
+      }
+    }
+  }
+}
+
+// Payload bytes from flash, a small buffer at a time, into the CRC.
+class Reader {
+public:
+  Reader(uint32_t addr, uint32_t len)
+      : addr_(addr), left_(len), pos_(0), len_(0), crc_(0xFFFFFFFFUL) {}
+
+  bool next(uint8_t &out) {
+    if (pos_ == len_) {
+      if (left_ == 0) {
+        return false;
+      }
+      len_ = left_ < sizeof(buf_) ? left_ : (uint32_t)sizeof(buf_);
+      QspiFlash::read(addr_, buf_, len_);
+      crc_ = crc32(crc_, buf_, len_);
+      addr_ += len_;
+      left_ -= len_;
+      pos_ = 0;
+    }
+    out = buf_[pos_++];
+    return true;
+  }
+
+  bool exhausted() const { return pos_ == len_ && left_ == 0; }
+  uint32_t crc() const { return crc_; }
+
+private:
+  uint32_t addr_;
+  uint32_t left_;
+  uint32_t pos_;
+  uint32_t len_;
+  uint32_t crc_;
+  uint8_t buf_[64];
+};
+
+bool decode(const Field &field, uint16_t slot, const Header &header) {
+  const uint32_t base = (uint32_t)slot * slotBytes(field);
+  if (header.payload_bytes > slotBytes(field) - QspiFlash::kPageBytes) {
+    return false;
+  }
+  Reader in(base + QspiFlash::kPageBytes, header.payload_bytes);
+  const uint32_t end = rawBytes(field);
+  const float scale = 1.0f / 255.0f;
+  uint32_t pos = 0;
+  uint8_t value = 0;
+  uint8_t token;
+  while (pos < end && in.next(token)) {
+    const bool repeat = (token & 0x80) != 0;
+    const uint32_t count = repeat ? (uint32_t)(token & 0x7F) + 3 : (uint32_t)token + 1;
+    if (count > end - pos) {
+      return false;
+    }
+    uint8_t delta = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+      if ((!repeat || i == 0) && !in.next(delta)) {
+        return false;
+      }
+      value = (uint8_t)(value + delta);
+      *cellAt(field, pos++) = RdCells::fromFloat((float)value * scale);
+    }
+  }
+  return pos == end && in.exhausted() && headerCrc(in.crc(), header) == header.crc;
+}
+} // namespace
+
+bool restore(const Field &field, Params &params, const Hooks &hooks) {
+  if (!QspiFlash::begin()) {
+    return false;
+  }
+  const uint32_t start_ms = now(hooks);
+  uint32_t below = 0xFFFFFFFFUL;
+  uint16_t slot;
+  Header header;
+  char line[96];
+  while (newest(field, below, slot, header)) {
+    if (decode(field, slot, header)) {
+      params = header.params;
+      snprintf(line, sizeof(line), "RD: restored snapshot seq=%lu bytes=%lu/%lu in %lu ms",
+               (unsigned long)header.seq, (unsigned long)header.payload_bytes,
+               (unsigned long)rawBytes(field), (unsigned long)(now(hooks) - start_ms));
+      log(hooks, line);
+      return true;
+    }
+    snprintf(line, sizeof(line), "RD: snapshot seq=%lu is corrupt", (unsigned long)header.seq);
+    log(hooks, line);
+    below = header.seq;
+  }
+  return false;
+}
+
+void Writer::Encoder::start(uint32_t bytes) {
+  pos_ = 0;
+  end_ = bytes;
+  prev_ = 0;
+}
+
+uint32_t Writer::Encoder::fill(const uint8_t *staged, uint8_t *out, uint32_t cap) {
+  uint32_t n = 0;
+  uint8_t q[kMaxRun];
+  uint8_t d[kMaxRun];
+  while (pos_ < end_ && cap - n >= 2) {
+    const uint32_t avail = end_ - pos_ < kMaxRun ? end_ - pos_ : kMaxRun;
+    // Deltas are worked out only as far as the token looks.
+    uint32_t have = 0;
+    auto deltaAt = [&](uint32_t i) {
+      for (; have <= i; ++have) {
+        q[have] = staged[pos_ + have];
+        d[have] = (uint8_t)(q[have] - (have == 0 ? prev_ : q[have - 1]));
+      }
+      return d[i];
+    };
+
+    uint32_t take = 1;
+    const uint8_t first = deltaAt(0);
+    while (take < avail && deltaAt(take) == first) {
+      ++take;
+    }
+    if (take >= 3) {
+      out[n++] = (uint8_t)(0x80 | (take - 3));
+      out[n++] = first;
+    } else {
+      const uint32_t room = cap - n - 1 < kMaxLiterals ? cap - n - 1 : kMaxLiterals;
+      take = 0;
+      while (take < avail && take < room) {
+        if (take + 2 < avail && deltaAt(take) == deltaAt(take + 1) &&
+            deltaAt(take) == deltaAt(take + 2)) {
+          break;
+        }
+        ++take;
+      }
+      deltaAt(take - 1);
+      out[n++] = (uint8_t)(take - 1);
+      memcpy(out + n, d, take);
+      n += take;
+    }
+    prev_ = q[take - 1];
+    pos_ += take;
+  }
+  return n;
+}
+
+Writer::Writer(uint32_t interval_ms, uint8_t *staging, uint32_t staging_bytes, const Hooks &hooks)
+    : hooks_(hooks), interval_ms_(interval_ms), wait_ms_(0), stage_(Stage::kWait), sector_(0), slot_(0),
+      seq_(0), page_(0), payload_bytes_(0), crc_(0), params_{}, staging_(staging),
+      staging_bytes_(staging_bytes), encoder_(), pending_(0) {}
+
+void Writer::begin(const Field &field) {
+  uint16_t slot;
+  Header header;
+  if (newest(field, 0xFFFFFFFFUL, slot, header)) {
+    slot_ = (uint16_t)((slot + 1) % slotCount(field));
+    seq_ = header.seq + 1;
+  } else {
+    slot_ = 0;
+    seq_ = 0;
+  }
+  sector_ = 0;
+  stage_ = Stage::kErase;
+}
+
+void Writer::poll(uint32_t dt_ms, const Field &field, const Params &params) {
+  const uint32_t base = (uint32_t)slot_ * slotBytes(field);
+  switch (stage_) {
+  case Stage::kWait:
+    wait_ms_ += dt_ms;
+    if (wait_ms_ < interval_ms_ || rawBytes(field) > staging_bytes_ || !QspiFlash::begin() ||
+        slotCount(field) == 0) {
+      return;
+    }
+    wait_ms_ = 0;
+    begin(field);
+    return;
+
+  case Stage::kErase:
+    if (QspiFlash::busy()) {
+      return;
+    }
+    if (sector_ < slotBytes(field) / QspiFlash::kSectorBytes) {
+      QspiFlash::startErase(base + (uint32_t)sector_ * QspiFlash::kSectorBytes);
+      ++sector_;
+      return;
+    }
+    // Field and parameters from this one update; the payload is coded from
+    // the copy over the next polls while the solver carries on.
+    quantiseField(field, staging_);
+    params_ = params;
+    encoder_.start(rawBytes(field));
+    page_ = 1;
+    payload_bytes_ = 0;
+    pending_ = 0;
+    crc_ = 0xFFFFFFFFUL;
+    stage_ = Stage::kPayload;
+    return;
+
+  case Stage::kPayload: {
+    if (QspiFlash::busy()) {
+      return;
+    }
+    pending_ += encoder_.fill(staging_, buf_ + pending_, sizeof(buf_) - pending_);
+    if (pending_ == 0) {
+      stage_ = Stage::kHeader;
+      return;
+    }
+    const uint32_t n = pending_ < QspiFlash::kPageBytes ? pending_ : QspiFlash::kPageBytes;
+    QspiFlash::startProgram(base + page_ * QspiFlash::kPageBytes, buf_, n);
+    crc_ = crc32(crc_, buf_, n);
+    payload_bytes_ += n;
+    ++page_;
+    pending_ -= n;
+    memmove(buf_, buf_ + n, pending_);
+    return;
+  }
+
+  case Stage::kHeader: {
+    if (QspiFlash::busy()) {
+      return;
+    }
+    Header header{kMagic, kVersion, field.width, field.height, 0, seq_, payload_bytes_, params_, 0};
+    header.crc = headerCrc(crc_, header);
+    QspiFlash::startProgram(base, &header, sizeof(header));
+    stage_ = Stage::kWait;
+    char line[96];
+    snprintf(line, sizeof(line), "RD: snapshot seq=%lu slot=%u bytes=%lu/%lu", (unsigned long)seq_,
+             (unsigned)slot_, (unsigned long)payload_bytes_, (unsigned long)rawBytes(field));
+    log(hooks_, line);
+    return;
+  }
+  }
+}
+
+} // namespace RdSnapshot
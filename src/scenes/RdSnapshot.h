@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "scenes/RdKernels.h"
+
+// Reaction-diffusion state kept in QSPI flash across reboots.
+//
+// The snapshot region is a ring of slots, each a few sectors. A snapshot
+// goes into the slot after the newest one, so every sector is erased once
+// per trip round the ring. A slot is its 48-byte header in page 0 and the
+// payload from page 1. The header is programmed last and carries a CRC-32
+// over payload and header, so a slot torn by a reset never validates and
+// restore() falls back to the previous one.
+//
+// Payload: u then v, row by row, quantised to 8 bits and delta coded
+// (each byte minus the one before, mod 256). The deltas are run-length
+// coded:
+//   0x00-0x7F  (n + 1) literal deltas follow
+//   0x80-0xFF  repeat the following delta (n & 0x7F) + 3 times
+namespace RdSnapshot {
+
+using Cell = RdCells::Cell;
+
+// Cell (x, y) of both fields is at (y + 1) * stride + x + 1, the
+// HaloGeometry layout.
+struct Field {
+  Cell *u;
+  Cell *v;
+  uint16_t width;
+  uint16_t height;
+  uint16_t stride;
+
+  uint32_t index(int x, int y) const { return (uint32_t)(y + 1) * stride + x + 1; }
+};
+
+struct Params {
+  float feed;
+  float kill;
+  float diff_u;
+  float diff_v;
+  float dt_sim;
+  float phase;
+};
+
+// Where the module reports, and the clock restore() times itself with;
+// passed in so it builds without the Arduino core. Either may be null.
+struct Hooks {
+  void (*log)(const char *line);
+  uint32_t (*now_ms)();
+};
+
+// Decodes the newest valid snapshot of this grid size into `field`. False
+// when there is none; the halo is left for the step kernels to refresh.
+bool restore(const Field &field, Params &params, const Hooks &hooks);
+
+// Takes a snapshot every `interval_ms` of update time. Each write is spread
+// over updates, one flash operation per poll(), so no frame waits on an
+// erase. Once the sectors are erased, one poll quantises all of u and v into
+// `staging` (2 * width * height bytes) and takes the parameters, so the
+// snapshot is a single simulation state; later polls code it from there.
+class Writer {
+public:
+  enum class Stage : uint8_t { kWait, kErase, kPayload, kHeader };
+
+  Writer(uint32_t interval_ms, uint8_t *staging, uint32_t staging_bytes, const Hooks &hooks);
+
+  void poll(uint32_t dt_ms, const Field &field, const Params &params);
+
+  // kWait between snapshots; kHeader once only the header is left to program.
+  Stage stage() const { return stage_; }
+  // Payload size of the last finished snapshot.
+  uint32_t payloadBytes() const { return payload_bytes_; }
+
+private:
+
+  // Streams the run-length coded payload; resumable between polls.
+  class Encoder {
+  public:
+    void start(uint32_t bytes);
+    bool done() const { return pos_ == end_; }
+    // Appends whole tokens for `staged` to `out`; returns the bytes written.
+    uint32_t fill(const uint8_t *staged, uint8_t *out, uint32_t cap);
+
+  private:
+    uint32_t pos_;
+    uint32_t end_;
+    uint8_t prev_;
+  };
+
+  static constexpr uint32_t kMaxToken = 129;
+
+  void begin(const Field &field);
+
+  Hooks hooks_;
+  uint32_t interval_ms_;
+  uint32_t wait_ms_;
+  Stage stage_;
+  uint8_t sector_;
+  uint16_t slot_;
+  uint32_t seq_;
+  uint32_t page_;
+  uint32_t payload_bytes_;
+  uint32_t crc_;
+  Params params_;
+  uint8_t *staging_;
+  uint32_t staging_bytes_;
+  Encoder encoder_;
+  uint32_t pending_;
+  // Up to a page waiting to be programmed, plus the token that overran it.
+  uint8_t buf_[256 + kMaxToken];
+};
+
+} // namespace RdSnapshot
@@ -1,6 +1,8 @@
 #include "scenes/ReactionDiffusionScene.h"
 #include "BoardConfig.h"
 #include "PaletteUtils.h"
+#include "BufferOps.h"
+#include "Shader.h"
 
 namespace {
 // Color palette for the RD scene (Heatmap style: Blue -> Cyan -> Green -> Yellow -> Red)
@@ -8,43 +10,80 @@ namespace {
 uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
   return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
 }
+
+// Maps the v concentration (0.0 - 1.0) to a palette index.
+template <typename Halo>
+struct RdShader {
+  const RdCells::Cell *v;
+  const RdCells::Cell *row;
+
+  void beginRow(int32_t, int y) { row = v + Halo::index(0, y); }
+
+  uint8_t operator()(int32_t, int x) const { return RdCells::paletteIndex(row[x]); }
+};
+
+// Writes the v values of a frame's last step straight into the target.
+template <PixelFormat F>
+struct RdEmit {
+  static constexpr bool kEnabled = true;
+  Shader::PaletteSink<F> sink;
+
+  void operator()(int x, int y, RdCells::Cell v) const {
+    sink.write(x, y, RdCells::paletteIndex(v));
+  }
+};
+
+#if APP_RD_SNAPSHOT
+const RdSnapshot::Hooks kSnapshotHooks{[](const char *line) { Serial.println(line); },
+                                       []() -> uint32_t { return millis(); }};
+#endif
 } // namespace
 
-ReactionDiffusionScene::ReactionDiffusionScene()
+template <typename G>
+ReactionDiffusionSceneT<G>::ReactionDiffusionSceneT() : ReactionDiffusionSceneT(Resume{}) {}
+
+template <typename G>
+ReactionDiffusionSceneT<G>::ReactionDiffusionSceneT(const Resume &resume)
     : feed_(0.037f), kill_(0.060f), diff_u_(1.0f), diff_v_(0.5f), dt_sim_(0.5f),
-      current_buf_(0), weather_{}, phase_(0.0f),
+      tiles_(RdCells::fromFloat(APP_RD_CALM_DELTA), APP_RD_CALM_INTERVAL), health_log_ms_(0),
+      step_debt_(0), steps_run_(0),
+#if APP_RD_SNAPSHOT
+      snapshot_(APP_RD_SNAPSHOT_INTERVAL_MS, snapshot_staging_, sizeof(snapshot_staging_),
+                kSnapshotHooks),
+      restored_(false),
+#endif
+      weather_{}, phase_(resume.phase),
       cold_green_scale_q8_(255), allowed_count_(16), last_temp_warm_(0xFF),
       wind_x_(0.0f), wind_y_(0.0f) {
-  u_[0] = nullptr;
-  u_[1] = nullptr;
-  v_[0] = nullptr;
-  v_[1] = nullptr;
   for (uint8_t i = 0; i < 16; ++i) {
     allowed_indices_[i] = i;
   }
 }
 
-ReactionDiffusionScene::~ReactionDiffusionScene() {
-  if (u_[0]) delete[] u_[0];
-  if (u_[1]) delete[] u_[1];
-  if (v_[0]) delete[] v_[0];
-  if (v_[1]) delete[] v_[1];
+template <typename G>
+typename ReactionDiffusionSceneT<G>::Resume ReactionDiffusionSceneT<G>::resume() const {
+  Resume resume;
+  resume.phase = phase_;
+  return resume;
 }
 
-void ReactionDiffusionScene::begin(Adafruit_Protomatter &matrix) {
+template <typename G>
+void ReactionDiffusionSceneT<G>::begin(Adafruit_Protomatter &matrix) {
   (void)matrix;
   Serial.println("RD: begin");
-  
-  // Allocate buffers if not already done
-  if (!u_[0]) {
-    u_[0] = new float[kGridSize];
-    u_[1] = new float[kGridSize];
-    v_[0] = new float[kGridSize];
-    v_[1] = new float[kGridSize];
-    Serial.println("RD: allocated buffers");
-  }
 
+#if APP_RD_SNAPSHOT
+  // A snapshot from before a reboot stands in for the seed; its
+  // parameters hold until real weather arrives.
+  const bool had_weather = weather_.valid;
+  RdSnapshot::Params saved;
+  restored_ = RdSnapshot::restore(snapshotField(), saved, kSnapshotHooks);
+  if (!restored_) {
+    seed();
+  }
+#else
   seed();
+#endif
   
   // Initial palette setup if weather hasn't arrived
   if (!weather_.valid) {
@@ -53,18 +92,43 @@ void ReactionDiffusionScene::begin(Adafruit_Protomatter &matrix) {
     default_params.valid = true;
     setWeather(default_params);
   }
+#if APP_RD_SNAPSHOT
+  if (restored_) {
+    if (!had_weather) {
+      feed_ = saved.feed;
+      kill_ = saved.kill;
+      diff_u_ = saved.diff_u;
+      diff_v_ = saved.diff_v;
+      dt_sim_ = saved.dt_sim;
+    }
+    // A Resume phase is newer; 0 is a cold start.
+    if (phase_ == 0.0f) {
+      phase_ = saved.phase;
+    }
+  }
+#endif
   updatePalette();
 }
 
-void ReactionDiffusionScene::seed() {
+template <typename G>
+void ReactionDiffusionSceneT<G>::seed() {
   Serial.println("RD: seeding");
-  // Initialize: u=1, v=0 everywhere
-  for (int i = 0; i < kGridSize; ++i) {
-    u_[0][i] = 1.0f;
-    v_[0][i] = 0.0f;
-    u_[1][i] = 1.0f;
-    v_[1][i] = 0.0f;
+  // Initialize: u=1, v=0 everywhere. The DMAC fills u while the CPU
+  // clears v.
+  const Cell one = RdCells::fromFloat(1.0f);
+  BufferOps::Fence fence;
+  if (sizeof(Cell) == 4) {
+    uint32_t one_bits;
+    memcpy(&one_bits, &one, sizeof(one_bits));
+    fence = BufferOps::fill32(reinterpret_cast<uint32_t *>(u_), one_bits, kHaloCells);
+  } else {
+    uint16_t one_bits;
+    memcpy(&one_bits, &one, sizeof(one_bits));
+    fence = BufferOps::fill16(reinterpret_cast<uint16_t *>(u_), one_bits, kHaloCells);
   }
+  memset(v_, 0, sizeof(v_));
+  tiles_.wakeAll();
+  BufferOps::wait(fence);
 
   // Seed with random blocks of v=1, u=0.5
   for (int i = 0; i < 12; ++i) {
@@ -75,103 +139,73 @@ void ReactionDiffusionScene::seed() {
     for (int y = cy - r; y <= cy + r; ++y) {
       for (int x = cx - r; x <= cx + r; ++x) {
         if (x >= 0 && x < kWidth && y >= 0 && y < kHeight) {
-          int idx = y * kWidth + x;
-          u_[0][idx] = 0.5f;
-          v_[0][idx] = 0.25f + (float)random(100) / 200.0f;
+          int idx = Halo::index(x, y);
+          u_[idx] = RdCells::fromFloat(0.5f);
+          v_[idx] = RdCells::fromFloat(0.25f + (float)random(100) / 200.0f);
         }
       }
     }
   }
 }
 
-// Simple 3x3 Laplacian kernel
-float ReactionDiffusionScene::laplacian(int x, int y, const float *grid) {
-  float sum = 0.0f;
-  
-  // Center
-  int idx = y * kWidth + x;
-  sum += grid[idx] * -1.0f;
-
-  // Orthogonal neighbors (0.2)
-  int xm1 = (x - 1 + kWidth) % kWidth;
-  int xp1 = (x + 1) % kWidth;
-  int ym1 = (y - 1 + kHeight) % kHeight;
-  int yp1 = (y + 1) % kHeight;
-
-  sum += grid[y * kWidth + xm1] * 0.2f;
-  sum += grid[y * kWidth + xp1] * 0.2f;
-  sum += grid[ym1 * kWidth + x] * 0.2f;
-  sum += grid[yp1 * kWidth + x] * 0.2f;
-
-  // Diagonal neighbors (0.05)
-  sum += grid[ym1 * kWidth + xm1] * 0.05f;
-  sum += grid[ym1 * kWidth + xp1] * 0.05f;
-  sum += grid[yp1 * kWidth + xm1] * 0.05f;
-  sum += grid[yp1 * kWidth + xp1] * 0.05f;
-
-  return sum;
+template <typename G>
+template <typename Emit>
+void ReactionDiffusionSceneT<G>::step(const Emit &emit) {
+  // Each step covers 20 / kStepsPerUpdate explicit steps of dt_sim_
+#if APP_RD_FIXED_POINT && !APP_RD_IMPLICIT
+  // Clamped so a restored or weather-driven dt_sim_ cannot push the Q1.14
+  // kernels out of range, where they would reject the step.
+  const float dt = fminf(dt_sim_ * (20.0f / (float)kStepsPerUpdate), RdKernels::kMaxQ14Dt);
+#else
+  const float dt = dt_sim_ * (20.0f / (float)kStepsPerUpdate);
+#endif
+  const RdKernels::StepParams params{feed_, kill_, diff_u_, diff_v_, dt, wind_x_, wind_y_};
+#if APP_RD_IMPLICIT
+  RdImplicit::step(params, u_, v_, line_, tiles_, emit);
+#elif APP_RD_FIXED_POINT && APP_RD_DSP_KERNEL
+  RdKernels::stepGridDsp(params, u_, v_, ring_, tiles_, emit);
+#else
+  RdKernels::stepGrid(params, u_, v_, ring_, tiles_, emit);
+#endif
 }
 
-void ReactionDiffusionScene::step() {
-  const float *u = u_[current_buf_];
-  const float *v = v_[current_buf_];
-  
-  int next_buf = 1 - current_buf_;
-  float *next_u = u_[next_buf];
-  float *next_v = v_[next_buf];
-
-  const float inv_height = 1.0f / kHeight;
-
-  for (int y = 0; y < kHeight; ++y) {
-    float norm_y = (float)y * inv_height;
-    float local_kill = kill_ + (0.003f - (norm_y * 0.006f)); 
-
-    for (int x = 0; x < kWidth; ++x) {
-      int i = y * kWidth + x;
-      
-      float u_val = u[i];
-      float v_val = v[i];
-      
-      float uvv = u_val * v_val * v_val;
-      float lap_u = laplacian(x, y, u);
-      float lap_v = laplacian(x, y, v);
-
-      // Advection: Calculate central gradients
-      int xp1 = (x + 1) % kWidth;
-      int xm1 = (x - 1 + kWidth) % kWidth;
-      int yp1 = (y + 1) % kHeight;
-      int ym1 = (y - 1 + kHeight) % kHeight;
-      
-      float grad_u_x = (u[y * kWidth + xp1] - u[y * kWidth + xm1]) * 0.5f;
-      float grad_u_y = (u[yp1 * kWidth + x] - u[ym1 * kWidth + x]) * 0.5f;
-      float grad_v_x = (v[y * kWidth + xp1] - v[y * kWidth + xm1]) * 0.5f;
-      float grad_v_y = (v[yp1 * kWidth + x] - v[ym1 * kWidth + x]) * 0.5f;
-
-      float adv_u = -(wind_x_ * grad_u_x + wind_y_ * grad_u_y);
-      float adv_v = -(wind_x_ * grad_v_x + wind_y_ * grad_v_y);
-
-      float du = (diff_u_ * lap_u) - uvv + (feed_ * (1.0f - u_val));
-      float dv = (diff_v_ * lap_v) + uvv - ((feed_ + local_kill) * v_val);
-
-      if ((i & 0x7F) == 0) {
-        dv += ((float)random(100) - 50.0f) * 0.0001f;
-      }
+template <typename G>
+uint32_t ReactionDiffusionSceneT<G>::warmupMs() const {
+#if APP_RD_SNAPSHOT
+  if (restored_) {
+    return 0;
+  }
+#endif
+  return kWarmupMs;
+}
 
-      next_u[i] = u_val + ((du + adv_u) * dt_sim_);
-      next_v[i] = v_val + ((dv + adv_v) * dt_sim_);
+template <typename G>
+void ReactionDiffusionSceneT<G>::update(uint32_t dt_ms) {
+  advance(dt_ms, RdKernels::NoEmit());
+}
 
-      if (next_u[i] < 0.0f) next_u[i] = 0.0f;
-      else if (next_u[i] > 1.0f) next_u[i] = 1.0f;
-      
-      if (next_v[i] < 0.0f) next_v[i] = 0.0f;
-      else if (next_v[i] > 1.0f) next_v[i] = 1.0f;
-    }
+template <typename G>
+void ReactionDiffusionSceneT<G>::updateAndRender(uint32_t dt_ms, RenderTarget &target) {
+#if APP_RD_FUSED_RENDER
+  bool written;
+  if (target.format == PixelFormat::kIndexed8) {
+    using Sink = Shader::PaletteSink<PixelFormat::kIndexed8>;
+    written = advance(dt_ms, RdEmit<PixelFormat::kIndexed8>{Sink::make(target, palette_)});
+  } else {
+    using Sink = Shader::PaletteSink<PixelFormat::kRgb565>;
+    written = advance(dt_ms, RdEmit<PixelFormat::kRgb565>{Sink::make(target, palette_)});
   }
-
-  current_buf_ = next_buf;
+  if (!written) {
+    render(target);
+  }
+#else
+  Scene::updateAndRender(dt_ms, target);
+#endif
 }
 
-void ReactionDiffusionScene::update(uint32_t dt_ms) {
+template <typename G>
+template <typename Emit>
+bool ReactionDiffusionSceneT<G>::advance(uint32_t dt_ms, const Emit &emit) {
   phase_ += (float)dt_ms * 0.0005f; // Faster drift
   
   // Stronger modulation for more visible movement
@@ -187,7 +221,7 @@ void ReactionDiffusionScene::update(uint32_t dt_ms) {
      // 0-30mph maps to 0.0-0.4 advection strength
      wind_mag = weather_.wind_speed_mph * 0.012f;
      // Cap it to prevent numerical explosion
-     if (wind_mag > 0.5f) wind_mag = 0.5f; 
+     if (wind_mag > kMaxWind) wind_mag = kMaxWind;
   }
   
   wind_x_ = cosf(wind_angle) * wind_mag;
@@ -196,71 +230,91 @@ void ReactionDiffusionScene::update(uint32_t dt_ms) {
   float active_feed = feed_ + drift_f;
   float active_kill = kill_ + drift_k;
 
-  // Rain: 2x2 drops for better visibility
+  // Rain: 2x2 drops for better visibility, at a chance per kUpdateMs
   if (weather_.valid && weather_.precip_prob_pct > 10) {
-    if (random(100) < (weather_.precip_prob_pct / 8)) {
+    if (random(100L * kUpdateMs) < (long)(weather_.precip_prob_pct / 8) * (long)dt_ms) {
       int rx = random(kWidth - 1);
       int ry = random(kHeight - 1);
       for (int dy=0; dy<2; ++dy) {
         for (int dx=0; dx<2; ++dx) {
-          v_[current_buf_][(ry+dy) * kWidth + (rx+dx)] = 0.9f;
+          v_[Halo::index(rx + dx, ry + dy)] = RdCells::fromFloat(0.9f);
+          tiles_.wake(rx + dx, ry + dy);
         }
       }
     }
   }
 
-  for (int i = 0; i < 20; ++i) {
+  step_debt_ += (dt_ms < kMaxUpdateMs ? dt_ms : kMaxUpdateMs) * (uint32_t)kStepsPerUpdate;
+  const int steps = (int)(step_debt_ / kUpdateMs);
+  step_debt_ -= (uint32_t)steps * kUpdateMs;
+  steps_run_ += (uint32_t)steps;
+
+  for (int i = 0; i < steps; ++i) {
     float old_f = feed_;
     float old_k = kill_;
     feed_ = active_feed;
     kill_ = active_kill;
-    step();
+    if (i < steps - 1) {
+      step(RdKernels::NoEmit());
+    } else {
+      step(emit);
+    }
     feed_ = old_f;
     kill_ = old_k;
   }
 
-  static uint32_t last_check = 0;
-  if (millis() - last_check > 5000) {
-    last_check = millis();
-    float total_v = 0;
-    float max_v = 0;
-    for(int i=0; i<kGridSize; ++i) {
-      float val = v_[current_buf_][i];
-      total_v += val;
-      if (val > max_v) max_v = val;
-    }
+  // Health check on the v statistics the steps gathered; no grid scan
+  const float scale = 1.0f / (float)RdCells::fromFloat(1.0f);
+  const float total_v = (float)tiles_.vSum() * scale;
+  const float max_v = (float)tiles_.vMax() * scale;
+
+  health_log_ms_ += dt_ms;
+  if (health_log_ms_ > 5000) {
+    health_log_ms_ = 0;
     float avg_v = total_v / kGridSize;
 
     Serial.print("RD: avg_v=");
     Serial.print(avg_v, 4);
     Serial.print(" max_v=");
     Serial.println(max_v, 4);
-    
-    if (total_v < (kGridSize * 0.005f) || max_v < 0.01f) {
-      Serial.println("RD: field died, reseeding");
-      seed();
-    }
   }
+
+#if APP_RD_SNAPSHOT
+  snapshot_.poll(dt_ms, snapshotField(), snapshotParams());
+#endif
+
+  if (steps == 0) {
+    return false; // The statistics are last update's
+  }
+  if (total_v < (kGridSize * 0.005f) || max_v < 0.01f) {
+    Serial.println("RD: field died, reseeding");
+    seed();
+  }
+  return true;
 }
 
-void ReactionDiffusionScene::render(Adafruit_Protomatter &matrix) {
-  const float *v = v_[current_buf_];
-  
-  uint16_t *buffer = matrix.getBuffer();
-  
-  for (int i = 0; i < kGridSize; ++i) {
-    // Map v (0.0 - 1.0) to palette index (0 - 255)
-    // Adjusted multiplier to prevent over-saturation and show more movement detail
-    float val = v[i];
-    int idx = (int)(val * 600.0f); 
-    if (idx < 0) idx = 0;
-    if (idx > 255) idx = 255;
-    
-    buffer[i] = palette_[idx];
+template <typename G>
+RenderSpec ReactionDiffusionSceneT<G>::renderSpec() const {
+  if (kWidth == G::kWidth && kHeight == G::kHeight) {
+    return RenderSpec::panel();
   }
+  return RenderSpec{kWidth, kHeight, PixelFormat::kIndexed8, Upscale::kBilinear};
 }
 
-void ReactionDiffusionScene::setWeather(const WeatherParams &params) {
+template <typename G>
+void ReactionDiffusionSceneT<G>::render(RenderTarget &target) {
+  renderRows(target, 0, (uint16_t)kHeight);
+}
+
+template <typename G>
+void ReactionDiffusionSceneT<G>::renderRows(RenderTarget &target, uint16_t y0, uint16_t rows) {
+  RdShader<Halo> shader{v_, nullptr};
+  Shader::renderRows(target, y0, rows, Shader::Mapping<Shader::FixedCoords>::pixels(), shader,
+                     palette_);
+}
+
+template <typename G>
+void ReactionDiffusionSceneT<G>::setWeather(const WeatherParams &params) {
   weather_ = params;
   
   if (params.valid) {
@@ -329,7 +383,8 @@ void ReactionDiffusionScene::setWeather(const WeatherParams &params) {
   }
 }
 
-void ReactionDiffusionScene::updatePalette() {
+template <typename G>
+void ReactionDiffusionSceneT<G>::updatePalette() {
   // Use last_temp_warm_ as the warmth bias
   const int warm_offset = (int)last_temp_warm_ - 128;
   const int red_bias = (warm_offset * 20) / 128;
@@ -375,4 +430,6 @@ void ReactionDiffusionScene::updatePalette() {
       palette_[i] = PaletteUtils::color565(out[0], out[1], out[2]);
     }
   }
-}
\ No newline at end of file
+}
+
+template class ReactionDiffusionSceneT<PanelGeometry>;
@@ -1,21 +1,70 @@
 #pragma once
 
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "Geometry.h"
+#include "Perf.h"
 #include "Scene.h"
+#include "scenes/RdKernels.h"
+#if APP_RD_IMPLICIT
+#include "scenes/RdImplicit.h"
+#endif
+#if APP_RD_SNAPSHOT
+#include "scenes/RdSnapshot.h"
+#endif
 
-class ReactionDiffusionScene : public Scene {
+// Instantiated for PanelGeometry in ReactionDiffusionScene.cpp.
+template <typename G>
+class ReactionDiffusionSceneT : public Scene {
 public:
-  ReactionDiffusionScene();
-  virtual ~ReactionDiffusionScene();
+  // State kept by SceneManager while the scene is not resident.
+  struct Resume {
+    float phase = 0.0f;
+  };
+
+  ReactionDiffusionSceneT();
+  explicit ReactionDiffusionSceneT(const Resume &resume);
+  Resume resume() const;
 
   void begin(Adafruit_Protomatter &matrix) override;
+  uint32_t warmupMs() const override;
   void update(uint32_t dt_ms) override;
-  void render(Adafruit_Protomatter &matrix) override;
+  RenderSpec renderSpec() const override;
+  void render(RenderTarget &target) override;
+  void updateAndRender(uint32_t dt_ms, RenderTarget &target) override;
+  bool supportsRowRange() const override { return true; }
+  void renderRows(RenderTarget &target, uint16_t y0, uint16_t rows) override;
   void setWeather(const WeatherParams &params) override;
+  // Simulation steps run since construction.
+  uint32_t stepsRun() const { return steps_run_; }
 
 private:
-  static constexpr int kWidth = 64;
-  static constexpr int kHeight = 32;
-  static constexpr int kGridSize = kWidth * kHeight;
+  // Grid size follows APP_RD_GRID_SCALE_PCT; below 100% the grid is
+  // rendered as palette indices and upscaled by Engine.
+  using Grid = ScaledGeometry<G, APP_RD_GRID_SCALE_PCT>;
+  static constexpr int kWidth = Grid::kWidth;
+  static constexpr int kHeight = Grid::kHeight;
+  static constexpr int kGridSize = (int)Grid::kPixels;
+  // Cell storage, padded with the wrap-around halo the step kernels read.
+  using Halo = HaloGeometry<Grid>;
+  static constexpr int kHaloCells = (int)Halo::kCells;
+  // Evolution follows simulated time: kStepsPerUpdate steps per kUpdateMs
+  // of dt_ms (the ~30 FPS frame the parameters were tuned at), whatever the
+  // frame rate. dt_ms counts up to Scene::kMaxUpdateMs, the longest gap
+  // Engine reports, so every governor frame interval keeps full speed;
+  // time lost to a longer stall is dropped rather than caught up, so a
+  // frame that ran long cannot make the next one longer still. The wind
+  // cap: the explicit kernels go unstable past about half a cell per step.
+  static constexpr int kStepsPerUpdate = APP_RD_IMPLICIT ? APP_RD_IMPLICIT_STEPS : 20;
+  static constexpr uint32_t kUpdateMs = 33;
+  static constexpr float kMaxWind = APP_RD_IMPLICIT ? 1.5f : 0.5f;
+  static_assert(!(APP_RD_IMPLICIT && APP_RD_FIXED_POINT), "APP_RD_IMPLICIT needs float cells");
+  // Seed blobs take a few hundred updates to grow into a developed pattern.
+  static constexpr uint32_t kWarmupMs = 6000;
+  static_assert(APP_STRIP_ROWS > 0
+                    ? RenderSpec{kWidth, kHeight, PixelFormat::kIndexed8, Upscale::kBilinear}.fitsStrips()
+                    : RenderSpec{kWidth, kHeight, PixelFormat::kIndexed8, Upscale::kBilinear}.fitsScratch(),
+                "RD grid does not fit the Engine render scratch");
 
   // Gray-Scott parameters (Default "Spots" / "Cells")
   // F=0.0545, k=0.0620 -> Coral / Brains
@@ -26,13 +75,37 @@ private:
   float diff_v_;
   float dt_sim_;
 
-  // Ping-pong buffers
-  // We allocate these on the heap in begin() to save space when not in use, 
-  // or statically if we want to guarantee memory. Given SAMD51 192KB, 
-  // 2 * 2 * 4 * 2048 = 32KB is fine.
-  float *u_[2];
-  float *v_[2];
-  uint8_t current_buf_;
+  // Stepped in place, with two saved rows per field standing in for a
+  // second grid. Held inline: the scene only exists while it is the active
+  // scene in SceneManager's arena.
+  using Cell = RdCells::Cell;
+  Cell u_[kHaloCells];
+  Cell v_[kHaloCells];
+#if APP_RD_IMPLICIT
+  RdImplicit::Scratch<Grid> line_;
+#else
+  RdKernels::RowRing<Grid, Cell> ring_;
+#endif
+  // Which 8x8 tiles are still moving, and the v statistics the health
+  // check reads; both kept up by the step kernels.
+  RdKernels::Tiles<Grid, Cell> tiles_;
+  uint32_t health_log_ms_;
+  // Steps owed, in 1/kUpdateMs of a step.
+  uint32_t step_debt_;
+  uint32_t steps_run_;
+#if APP_RD_SNAPSHOT
+  // Quantised u and v while a snapshot is being written.
+  uint8_t snapshot_staging_[2 * kWidth * kHeight];
+  RdSnapshot::Writer snapshot_;
+  // begin() found a snapshot, so the field needs no warmup.
+  bool restored_;
+  RdSnapshot::Field snapshotField() {
+    return RdSnapshot::Field{u_, v_, (uint16_t)kWidth, (uint16_t)kHeight, (uint16_t)Halo::kStride};
+  }
+  RdSnapshot::Params snapshotParams() const {
+    return RdSnapshot::Params{feed_, kill_, diff_u_, diff_v_, dt_sim_, phase_};
+  }
+#endif
 
   uint16_t palette_[256];
   WeatherParams weather_;
@@ -45,8 +118,14 @@ private:
   float wind_x_;
   float wind_y_;
   
-  void step();
-  float laplacian(int x, int y, const float *grid);
+  // The frame's last step hands each cell to `emit` (see RdKernels).
+  // False when dt_ms did not add up to a step, so nothing was emitted.
+  template <typename Emit>
+  bool advance(uint32_t dt_ms, const Emit &emit);
+  template <typename Emit>
+  void step(const Emit &emit);
   void seed();
   void updatePalette();
 };
+
+using ReactionDiffusionScene = ReactionDiffusionSceneT<PanelGeometry>;
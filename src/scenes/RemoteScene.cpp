@@ -0,0 +1,20 @@
+#include "scenes/RemoteScene.h"
+
+#include "BufferOps.h"
+
+RemoteScene::RemoteScene(RemoteFrameReceiver &receiver)
+    : receiver_(receiver), frame_(nullptr) {}
+
+void RemoteScene::update(uint32_t dt_ms) {
+  (void)dt_ms;
+  frame_ = receiver_.present();
+}
+
+void RemoteScene::render(RenderTarget &target) {
+  const size_t bytes = (size_t)target.width * target.height * sizeof(uint16_t);
+  if (frame_) {
+    BufferOps::copy(target.rgb, frame_, bytes);
+  } else {
+    BufferOps::fill16(target.rgb, 0, bytes / sizeof(uint16_t));
+  }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "Scene.h"
+#include "net/RemoteFrameReceiver.h"
+
+// Shows frames streamed by a host renderer. Runs through Engine like any
+// other scene, so the current limiter, dimmer and crossfades still apply.
+class RemoteScene : public Scene {
+public:
+  explicit RemoteScene(RemoteFrameReceiver &receiver);
+  void update(uint32_t dt_ms) override;
+  void render(RenderTarget &target) override;
+
+private:
+  RemoteFrameReceiver &receiver_;
+  const uint16_t *frame_;
+};
@@ -41,8 +41,8 @@ void TestScene::update(uint32_t dt_ms) {
   }
 }
 
-void TestScene::render(Adafruit_Protomatter &matrix) {
-  uint16_t *buffer = matrix.getBuffer();
+void TestScene::render(RenderTarget &target) {
+  uint16_t *buffer = target.rgb;
   const uint32_t count = (uint32_t)kMatrixWidth * kMatrixHeight;
   for (uint32_t i = 0; i < count; ++i) {
     buffer[i] = 0;
@@ -9,7 +9,7 @@ public:
   TestScene();
   void begin(Adafruit_Protomatter &matrix) override;
   void update(uint32_t dt_ms) override;
-  void render(Adafruit_Protomatter &matrix) override;
+  void render(RenderTarget &target) override;
 
 private:
   static constexpr int32_t kFixedOne = 256;
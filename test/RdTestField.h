@@ -0,0 +1,43 @@
+#pragma once
+
+// Shared by the RD kernel tests: a field in the kernels' halo layout at
+// panel size, seeded the way ReactionDiffusionScene seeds.
+#include <Arduino.h>
+
+#include "Geometry.h"
+#include "scenes/RdKernels.h"
+
+namespace RdTestField {
+using Grid = Geometry<64, 32>;
+using Halo = HaloGeometry<Grid>;
+
+template <typename Cells>
+struct State {
+  typename Cells::Cell u[Halo::kCells];
+  typename Cells::Cell v[Halo::kCells];
+  RdKernels::RowRing<Grid, typename Cells::Cell> ring;
+};
+
+// u = 1 and v = 0, with blocks of v scattered the way the scene seeds;
+// where they fall follows `random_seed`.
+template <typename Cells>
+void seed(State<Cells> &s, unsigned long random_seed) {
+  for (uint32_t i = 0; i < Halo::kCells; ++i) {
+    s.u[i] = Cells::fromFloat(1.0f);
+    s.v[i] = Cells::fromFloat(0.0f);
+  }
+  randomSeed(random_seed);
+  for (int n = 0; n < 8; ++n) {
+    const int cx = (int)random(Grid::kWidth);
+    const int cy = (int)random(Grid::kHeight);
+    for (int y = cy - 3; y <= cy + 3; ++y) {
+      for (int x = cx - 3; x <= cx + 3; ++x) {
+        if (x >= 0 && x < Grid::kWidth && y >= 0 && y < Grid::kHeight) {
+          s.u[Halo::index(x, y)] = Cells::fromFloat(0.5f);
+          s.v[Halo::index(x, y)] = Cells::fromFloat(0.25f + (float)random(100) / 200.0f);
+        }
+      }
+    }
+  }
+}
+} // namespace RdTestField
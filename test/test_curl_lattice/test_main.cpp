@@ -0,0 +1,106 @@
+// The Curl lattice shader against the per-pixel one, at the clearest and
+// cloudiest noise scales the scene's weather maps to: the interpolated
+// curl must land in the per-pixel direction slot or the one next to it at
+// 99% of pixels, as kMaxNodeSpacing promises.
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "BoardConfig.h"
+#include "scenes/CurlKernels.h"
+
+namespace {
+using Coords = CurlKernels::CurlCoords;
+constexpr uint16_t kWidth = kMatrixWidth;
+constexpr uint16_t kHeight = kMatrixHeight;
+constexpr uint32_t kPixels = (uint32_t)kWidth * kHeight;
+// CurlNoiseScene::setWeather(): 0.1 at 0% cloud cover, 0.04 at 100%.
+constexpr float kClearScale = 0.1f;
+constexpr float kCloudyScale = 0.04f;
+constexpr int kFrames = 16;
+
+uint8_t per_pixel_[kPixels];
+uint8_t lattice_[kPixels];
+uint16_t palette_[16];
+
+RenderTarget target(uint8_t *buf) {
+  RenderTarget t{};
+  t.width = kWidth;
+  t.height = kHeight;
+  t.format = PixelFormat::kIndexed8;
+  t.index = buf;
+  return t;
+}
+
+struct Agreement {
+  uint32_t same;
+  uint32_t near; // same or one slot either way
+  uint32_t total;
+};
+
+// Renders frames along z both ways, with each direction bucket as its own
+// slot, and compares slot by slot.
+Agreement compare(float scale) {
+  const uint8_t shift = CurlKernels::latticeShift(scale);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, shift);
+  const Shader::Mapping<Coords> map = Shader::Mapping<Coords>::make(0.0f, scale, 0.0f, scale);
+
+  Agreement a{0, 0, 0};
+  for (int frame = 0; frame < kFrames; ++frame) {
+    const Coords::Value z = Coords::fromFloat(3.0f + 7.3f * frame);
+
+    CurlKernels::CurlShader<Coords> exact;
+    exact.z = z;
+    CurlKernels::CurlLatticeShader<Coords, (kWidth >> 1) + 2> lattice;
+    lattice.map = map;
+    lattice.z = z;
+    lattice.shift = shift;
+    lattice.nodes = (uint16_t)(((kWidth - 1) >> shift) + 2);
+    lattice.row = -2;
+    for (uint8_t i = 0; i < 16; ++i) {
+      exact.slots[i] = i;
+      lattice.slots[i] = i;
+    }
+
+    RenderTarget exact_target = target(per_pixel_);
+    RenderTarget lattice_target = target(lattice_);
+    Shader::renderRows(exact_target, 0, kHeight, map, exact, palette_);
+    Shader::renderRows(lattice_target, 0, kHeight, map, lattice, palette_);
+
+    for (uint32_t i = 0; i < kPixels; ++i) {
+      const uint8_t d = (uint8_t)((per_pixel_[i] - lattice_[i]) & 0x0F);
+      a.same += d == 0;
+      a.near += d == 0 || d == 1 || d == 15;
+      ++a.total;
+    }
+  }
+
+  char line[112];
+  snprintf(line, sizeof(line), "scale %.2f, %u px lattice: %.1f%% same slot, %.2f%% within one", scale,
+           1u << shift, 100.0 * a.same / a.total, 100.0 * a.near / a.total);
+  TEST_MESSAGE(line);
+  return a;
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_clear_sky_lattice_tracks_per_pixel() {
+  const Agreement a = compare(kClearScale);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(a.total - a.total / 100, a.near);
+}
+
+void test_cloudy_lattice_tracks_per_pixel() {
+  const Agreement a = compare(kCloudyScale);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(a.total - a.total / 100, a.near);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_clear_sky_lattice_tracks_per_pixel);
+  RUN_TEST(test_cloudy_lattice_tracks_per_pixel);
+  return UNITY_END();
+}
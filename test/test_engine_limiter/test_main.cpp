@@ -0,0 +1,125 @@
+// The current limiter on a panel-resolution scene, which needs no post pass
+// of its own: idle frames skip the pass apart from periodic probes, and a
+// bright frame still engages the limiter within a probe interval.
+#include <unity.h>
+
+#include <stdio.h>
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "Engine.h"
+
+namespace {
+constexpr uint32_t kFrameMs = 33;
+// About a quarter, three fifths and all of full duty.
+constexpr uint16_t kDim = 0x4208;
+constexpr uint16_t kBright = 0x9492;
+constexpr uint16_t kWhite = 0xFFFF;
+
+// Fills the framebuffer with one colour every frame.
+class FlatScene : public Scene {
+public:
+  uint16_t color = kDim;
+
+  void update(uint32_t dt_ms) override { (void)dt_ms; }
+
+  void render(RenderTarget &target) override {
+    for (uint32_t i = 0; i < (uint32_t)target.width * target.height; ++i) {
+      target.rgb[i] = color;
+    }
+  }
+};
+
+FlatScene scene_;
+Engine engine_(matrix, kFrameMs);
+uint32_t now_ms_ = 0;
+
+void run(int frames) {
+  for (int i = 0; i < frames; ++i) {
+    now_ms_ += kFrameMs;
+    engine_.tick(now_ms_);
+  }
+}
+
+void report(const char *name, uint32_t frames, uint32_t measured) {
+  const Engine::Stats &stats = engine_.stats();
+  char line[112];
+  snprintf(line, sizeof(line), "%s: %lu/%lu frames measured, demand %umA est %umA limiter %u%%", name,
+           (unsigned long)measured, (unsigned long)frames, stats.demand_ma, stats.estimated_ma,
+           stats.limiter_pct);
+  TEST_MESSAGE(line);
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_idle_frames_skip_the_pass() {
+  scene_.color = kDim;
+  engine_.setScene(&scene_);
+  run(1);
+  const uint32_t before = engine_.stats().post_frames;
+  const int frames = APP_LIMITER_PROBE_FRAMES * 10;
+  run(frames);
+  const uint32_t measured = engine_.stats().post_frames - before;
+  report("dim", frames, measured);
+  TEST_ASSERT_EQUAL_UINT32(frames / APP_LIMITER_PROBE_FRAMES, measured);
+  TEST_ASSERT_GREATER_THAN_UINT32(0, engine_.stats().demand_ma);
+  TEST_ASSERT_EQUAL_UINT8(100, engine_.stats().limiter_pct);
+}
+
+// Under the budget but near it: measured every frame without scaling.
+void test_near_budget_measures_every_frame() {
+  scene_.color = kBright;
+  run(APP_LIMITER_PROBE_FRAMES + 1);
+  const uint32_t before = engine_.stats().post_frames;
+  const int frames = 30;
+  run(frames);
+  const uint32_t measured = engine_.stats().post_frames - before;
+  report("bright", frames, measured);
+  TEST_ASSERT_EQUAL_UINT32(frames, measured);
+  TEST_ASSERT_GREATER_THAN_UINT32(APP_POWER_BUDGET_MA * 3 / 4, engine_.stats().demand_ma);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(APP_POWER_BUDGET_MA, engine_.stats().demand_ma);
+  TEST_ASSERT_EQUAL_UINT8(100, engine_.stats().limiter_pct);
+}
+
+// Full white is over the budget: the next probe catches it, and from then
+// on every frame is measured and scaled under the budget.
+void test_bright_frames_engage_limiter() {
+  scene_.color = kWhite;
+  run(APP_LIMITER_PROBE_FRAMES + 1);
+  TEST_ASSERT_LESS_THAN_UINT32(100, engine_.stats().limiter_pct);
+
+  const uint32_t before = engine_.stats().post_frames;
+  const int frames = 30;
+  run(frames);
+  const uint32_t measured = engine_.stats().post_frames - before;
+  report("white", frames, measured);
+  TEST_ASSERT_EQUAL_UINT32(frames, measured);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(APP_POWER_BUDGET_MA, engine_.stats().estimated_ma);
+}
+
+// Back to dim: the limiter releases over the following frames, still
+// measuring each, then drops back to probing.
+void test_limiter_releases_then_idles() {
+  scene_.color = kDim;
+  run(256 / 4 + 2);
+  TEST_ASSERT_EQUAL_UINT8(100, engine_.stats().limiter_pct);
+
+  const uint32_t before = engine_.stats().post_frames;
+  const int frames = APP_LIMITER_PROBE_FRAMES * 10;
+  run(frames);
+  const uint32_t measured = engine_.stats().post_frames - before;
+  report("dim again", frames, measured);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(frames / APP_LIMITER_PROBE_FRAMES + 1, measured);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_idle_frames_skip_the_pass);
+  RUN_TEST(test_near_budget_measures_every_frame);
+  RUN_TEST(test_bright_frames_engage_limiter);
+  RUN_TEST(test_limiter_releases_then_idles);
+  return UNITY_END();
+}
@@ -0,0 +1,138 @@
+// The Q16.16 noise path against the float one: perlinGradientQ16() against
+// perlinGradient(), and sector16() against the atan2f buckets, over grids
+// of inputs.
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "Noise.h"
+
+namespace {
+constexpr float kOneQ16 = 65536.0f;
+
+int32_t toQ16(float v) {
+  return (int32_t)lroundf(v * kOneQ16);
+}
+
+// The float shader's bucket: floor(angle / 22.5 degrees) over [0, 360).
+int floatSector(float x, float y) {
+  float angle = atan2f(y, x);
+  if (angle < 0.0f) {
+    angle += 2.0f * (float)M_PI;
+  }
+  return (int)(angle * 16.0f / (2.0f * (float)M_PI)) & 0x0F;
+}
+
+// Within float rounding of a bucket edge, either answer is right.
+bool nearEdge(float x, float y) {
+  float angle = atan2f(y, x);
+  if (angle < 0.0f) {
+    angle += 2.0f * (float)M_PI;
+  }
+  const float buckets = angle * 16.0f / (2.0f * (float)M_PI);
+  return fabsf(buckets - roundf(buckets)) < 1e-4f;
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+// Value and derivatives across several lattice cells and z slices, at
+// sub-pixel offsets the scene uses.
+void test_gradient_q16_tracks_float() {
+  float max_value = 0.0f;
+  float max_slope = 0.0f;
+  double sum_slope = 0.0;
+  uint32_t samples = 0;
+  for (int k = 0; k < 5; ++k) {
+    const float z = 12.5f + 0.37f * k;
+    for (int j = 0; j < 64; ++j) {
+      for (int i = 0; i < 128; ++i) {
+        const float x = -3.0f + i * 0.0613f;
+        const float y = 40.0f + j * 0.0791f;
+        const Noise::Gradient f = Noise::perlinGradient(x, y, z);
+        const Noise::GradientQ16 q = Noise::perlinGradientQ16(toQ16(x), toQ16(y), toQ16(z));
+        max_value = fmaxf(max_value, fabsf(q.value / kOneQ16 - f.value));
+        const float slope = fmaxf(fabsf(q.dx / kOneQ16 - f.dx), fabsf(q.dy / kOneQ16 - f.dy));
+        max_slope = fmaxf(max_slope, slope);
+        sum_slope += slope;
+        ++samples;
+      }
+    }
+  }
+  char line[96];
+  snprintf(line, sizeof(line), "q16 vs float: value max %.6f, slope max %.6f mean %.7f", max_value,
+           max_slope, sum_slope / samples);
+  TEST_MESSAGE(line);
+  // "Within a few Q16 units": 16 units is 0.00024.
+  TEST_ASSERT_LESS_THAN_FLOAT(16.0f / kOneQ16, max_value);
+  TEST_ASSERT_LESS_THAN_FLOAT(16.0f / kOneQ16, max_slope);
+}
+
+// Every direction on a ring of integer vectors, at several magnitudes.
+void test_sector16_matches_atan2f() {
+  static const int32_t kRadii[] = {1, 7, 300, 65536, 1 << 20};
+  uint32_t checked = 0;
+  for (int32_t radius : kRadii) {
+    for (int step = 0; step < 3600; ++step) {
+      const float angle = step * (2.0f * (float)M_PI / 3600.0f);
+      const int32_t x = (int32_t)lroundf(radius * cosf(angle));
+      const int32_t y = (int32_t)lroundf(radius * sinf(angle));
+      if ((x == 0 && y == 0) || nearEdge((float)x, (float)y)) {
+        continue;
+      }
+      if (Noise::sector16(x, y) != floatSector((float)x, (float)y)) {
+        char line[96];
+        snprintf(line, sizeof(line), "(%ld, %ld): sector16 %u, atan2f %d", (long)x, (long)y,
+                 Noise::sector16(x, y), floatSector((float)x, (float)y));
+        TEST_FAIL_MESSAGE(line);
+      }
+      ++checked;
+    }
+  }
+  TEST_ASSERT_GREATER_THAN_UINT32(10000, checked);
+}
+
+// The axes and diagonals exactly: edges belong to the sector they start.
+void test_sector16_edges() {
+  TEST_ASSERT_EQUAL_UINT8(0, Noise::sector16(5, 0));
+  TEST_ASSERT_EQUAL_UINT8(2, Noise::sector16(5, 5));
+  TEST_ASSERT_EQUAL_UINT8(4, Noise::sector16(0, 5));
+  TEST_ASSERT_EQUAL_UINT8(6, Noise::sector16(-5, 5));
+  TEST_ASSERT_EQUAL_UINT8(8, Noise::sector16(-5, 0));
+  TEST_ASSERT_EQUAL_UINT8(10, Noise::sector16(-5, -5));
+  TEST_ASSERT_EQUAL_UINT8(12, Noise::sector16(0, -5));
+  TEST_ASSERT_EQUAL_UINT8(14, Noise::sector16(5, -5));
+}
+
+// What the Curl shader sees: the curl bucket of the Q16 gradient against
+// the float one, over a frame's worth of samples.
+void test_curl_buckets_agree() {
+  uint32_t same = 0;
+  uint32_t total = 0;
+  for (int j = 0; j < 32; ++j) {
+    for (int i = 0; i < 64; ++i) {
+      const float x = i * 0.08f;
+      const float y = j * 0.08f;
+      const Noise::Gradient f = Noise::perlinGradient(x, y, 12.5f);
+      const Noise::GradientQ16 q = Noise::perlinGradientQ16(toQ16(x), toQ16(y), toQ16(12.5f));
+      same += Noise::sector16(-q.dy, q.dx) == floatSector(-f.dy, f.dx);
+      ++total;
+    }
+  }
+  char line[64];
+  snprintf(line, sizeof(line), "curl buckets: %lu/%lu agree", (unsigned long)same, (unsigned long)total);
+  TEST_MESSAGE(line);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(total - total / 100, same);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_gradient_q16_tracks_float);
+  RUN_TEST(test_sector16_matches_atan2f);
+  RUN_TEST(test_sector16_edges);
+  RUN_TEST(test_curl_buckets_agree);
+  return UNITY_END();
+}
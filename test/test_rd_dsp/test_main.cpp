@@ -0,0 +1,102 @@
+// The DSP-extension RD kernel (portable Dsp:: build) against the scalar
+// Q1.14 kernel: same seeded grid, same noise sequence, identical cells
+// after every step. Also checks that parameter sets the Q15 coefficients
+// cannot represent are rejected rather than saturated.
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../RdTestField.h"
+#include "AppConfig.h"
+#include "scenes/RdKernels.h"
+
+namespace {
+using RdTestField::Grid;
+using RdTestField::Halo;
+using State = RdTestField::State<RdQ14Cells>;
+using Tiles = RdKernels::Tiles<Grid, int16_t>;
+constexpr int kSteps = 200;
+constexpr unsigned long kSeed = 1234;
+
+State scalar_;
+State dsp_;
+
+void assertSameCells(int step) {
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    for (int x = 0; x < Grid::kWidth; ++x) {
+      const int i = Halo::index(x, y);
+      if (scalar_.u[i] != dsp_.u[i] || scalar_.v[i] != dsp_.v[i]) {
+        char line[96];
+        snprintf(line, sizeof(line), "step %d cell (%d, %d): u %d/%d v %d/%d", step, x, y,
+                 scalar_.u[i], dsp_.u[i], scalar_.v[i], dsp_.v[i]);
+        TEST_FAIL_MESSAGE(line);
+      }
+    }
+  }
+}
+
+// Steps both kernels from the same seed, each with its own tiles and the
+// same random() sequence, comparing after every step.
+void runBoth(const RdKernels::StepParams &p, uint8_t calm_interval) {
+  RdTestField::seed(scalar_, kSeed);
+  RdTestField::seed(dsp_, kSeed);
+  Tiles scalar_tiles(RdQ14Cells::fromFloat(APP_RD_CALM_DELTA), calm_interval);
+  Tiles dsp_tiles(RdQ14Cells::fromFloat(APP_RD_CALM_DELTA), calm_interval);
+  for (int step = 0; step < kSteps; ++step) {
+    randomSeed(kSeed + step);
+    RdKernels::stepGrid(p, scalar_.u, scalar_.v, scalar_.ring, scalar_tiles);
+    randomSeed(kSeed + step);
+    RdKernels::stepGridDsp(p, dsp_.u, dsp_.v, dsp_.ring, dsp_tiles);
+    assertSameCells(step);
+  }
+  // The grid must have moved, or the comparison proves little.
+  RdTestField::seed(dsp_, kSeed);
+  TEST_ASSERT_TRUE(memcmp(scalar_.v, dsp_.v, sizeof(dsp_.v)) != 0);
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_matches_scalar_without_wind() {
+  runBoth(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, 0.5f, 0.0f, 0.0f}, 1);
+}
+
+void test_matches_scalar_with_wind() {
+  runBoth(RdKernels::StepParams{0.030f, 0.062f, 1.2f, 0.6f, 0.7f, 0.3f, -0.2f}, 1);
+}
+
+// Calm tiles skipped on both sides in the same pattern.
+void test_matches_scalar_with_calm_tiles() {
+  runBoth(RdKernels::StepParams{0.065f, 0.065f, 1.0f, 0.5f, 0.6f, 0.0f, 0.0f}, APP_RD_CALM_INTERVAL);
+}
+
+void test_rejects_unrepresentable_params() {
+  TEST_ASSERT_TRUE(RdKernels::fitsQ15(RdKernels::StepParams{0.037f, 0.060f, 1.2f, 0.6f, 0.7f, 0.3f, 0.3f}));
+  // dt itself is a coefficient (on uvv): 1.0 would saturate to 32767/32768.
+  TEST_ASSERT_FALSE(RdKernels::fitsQ15(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, 1.0f, 0.0f, 0.0f}));
+  // 0.4 * diff_u * dt over 1.
+  TEST_ASSERT_FALSE(RdKernels::fitsQ15(RdKernels::StepParams{0.037f, 0.060f, 3.0f, 0.5f, 0.9f, 0.0f, 0.0f}));
+  TEST_ASSERT_FALSE(RdKernels::fitsQ15(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, 0.5f, 4.0f, 0.0f}));
+  TEST_ASSERT_FALSE(RdKernels::fitsQ15(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, -0.1f, 0.0f, 0.0f}));
+
+  RdTestField::seed(scalar_, kSeed);
+  RdTestField::seed(dsp_, kSeed);
+  Tiles tiles(0, 1);
+  const RdKernels::StepParams too_long{0.037f, 0.060f, 1.0f, 0.5f, 1.5f, 0.0f, 0.0f};
+  RdKernels::stepGrid(too_long, scalar_.u, scalar_.v, scalar_.ring, tiles);
+  RdKernels::stepGridDsp(too_long, scalar_.u, scalar_.v, scalar_.ring, tiles);
+  TEST_ASSERT_EQUAL_MEMORY(dsp_.u, scalar_.u, sizeof(dsp_.u));
+  TEST_ASSERT_EQUAL_MEMORY(dsp_.v, scalar_.v, sizeof(dsp_.v));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_scalar_without_wind);
+  RUN_TEST(test_matches_scalar_with_wind);
+  RUN_TEST(test_matches_scalar_with_calm_tiles);
+  RUN_TEST(test_rejects_unrepresentable_params);
+  return UNITY_END();
+}
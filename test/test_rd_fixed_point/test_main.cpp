@@ -0,0 +1,104 @@
+// The Q1.14 RD kernel against the float kernel: both stepped from one seeded
+// field with the same noise sequence, the fields must stay close. Also
+// checks the Q1.14 range at the scene's extreme parameters.
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "../RdTestField.h"
+#include "scenes/RdKernels.h"
+
+namespace {
+using RdTestField::Grid;
+using RdTestField::Halo;
+using RdTestField::State;
+constexpr unsigned long kSeed = 4321;
+
+State<RdFloatCells> float_;
+State<RdQ14Cells> q14_;
+
+struct Error {
+  float max;
+  float mean;
+};
+
+Error compare() {
+  Error e{0.0f, 0.0f};
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    for (int x = 0; x < Grid::kWidth; ++x) {
+      const int i = Halo::index(x, y);
+      const float du = fabsf(float_.u[i] - RdQ14Cells::toFloat(q14_.u[i]));
+      const float dv = fabsf(float_.v[i] - RdQ14Cells::toFloat(q14_.v[i]));
+      e.max = fmaxf(e.max, fmaxf(du, dv));
+      e.mean += du + dv;
+    }
+  }
+  e.mean /= 2.0f * Grid::kPixels;
+  return e;
+}
+
+// Steps both solvers `steps` times, every tile every step, and returns the
+// error at the end.
+Error run(const RdKernels::StepParams &p, int steps) {
+  RdTestField::seed(float_, kSeed);
+  RdTestField::seed(q14_, kSeed);
+  RdKernels::Tiles<Grid, float> float_tiles(0.0f, 1);
+  RdKernels::Tiles<Grid, int16_t> q14_tiles(0, 1);
+  for (int step = 0; step < steps; ++step) {
+    randomSeed(kSeed + step);
+    RdKernels::stepGrid(p, float_.u, float_.v, float_.ring, float_tiles);
+    randomSeed(kSeed + step);
+    RdKernels::stepGrid(p, q14_.u, q14_.v, q14_.ring, q14_tiles);
+  }
+  const Error e = compare();
+  char line[96];
+  snprintf(line, sizeof(line), "dt=%.2f %d steps: max error %.5f mean %.6f", p.dt, steps, e.max, e.mean);
+  TEST_MESSAGE(line);
+  return e;
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+// One update's worth of steps at the scene's default rates.
+void test_one_update_tracks_float() {
+  const Error e = run(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, 0.5f, 0.0f, 0.0f}, 20);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.002f, e.max);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.0002f, e.mean);
+}
+
+// Ten updates, with wind: rounding compounds but stays small.
+void test_many_steps_track_float() {
+  const Error e = run(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, 0.5f, 0.3f, -0.2f}, 200);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.01f, e.max);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.002f, e.mean);
+}
+
+// The longest step the scene lets the Q1.14 kernels take.
+void test_longest_step_tracks_float() {
+  const RdKernels::StepParams p{0.065f, 0.065f, 1.2f, 0.6f, RdKernels::kMaxQ14Dt, 0.0f, 0.0f};
+  TEST_ASSERT_TRUE(RdKernels::fitsQ15(p));
+  const Error e = run(p, 20);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.005f, e.max);
+  TEST_ASSERT_LESS_THAN_FLOAT(0.0005f, e.mean);
+}
+
+// Windiest weather the scene maps to (diff 1.2 / 0.6, dt 0.7) fits, and the
+// dt limit is where fitsQ15() starts rejecting.
+void test_scene_range_fits() {
+  TEST_ASSERT_TRUE(RdKernels::fitsQ15(RdKernels::StepParams{0.065f, 0.065f, 1.2f, 0.6f, 0.7f, 1.0f, 1.0f}));
+  TEST_ASSERT_TRUE(RdKernels::fitsQ15(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, RdKernels::kMaxQ14Dt, 0.0f, 0.0f}));
+  TEST_ASSERT_FALSE(RdKernels::fitsQ15(RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, 1.0f, 0.0f, 0.0f}));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_one_update_tracks_float);
+  RUN_TEST(test_many_steps_track_float);
+  RUN_TEST(test_longest_step_tracks_float);
+  RUN_TEST(test_scene_range_fits);
+  return UNITY_END();
+}
@@ -0,0 +1,68 @@
+// RD advances by simulated time: the same stretch of it runs the same
+// number of steps at every governor frame interval, and only time past
+// Scene::kMaxUpdateMs in one update is dropped.
+#include <unity.h>
+
+#include <stdio.h>
+
+#include "BoardConfig.h"
+#include "QspiFlash.h"
+#include "scenes/ReactionDiffusionScene.h"
+
+namespace {
+// RD begin() restores any snapshot it finds; this binary's own flash file,
+// deleted before each test, keeps it seeding afresh.
+constexpr const char *kFlashFile = "qspi_test_rd_frame_rate.bin";
+// The Day, Evening and Night profiles' frame intervals (PowerGovernor).
+constexpr uint32_t kFrameMs[] = {33, 50, 80};
+// Divisible by each of them, so no step debt is left over.
+constexpr uint32_t kSimulatedMs = 33 * 50 * 16;
+// Steps the scene takes per 33 ms of simulated time.
+constexpr uint32_t kStepsPer33Ms = APP_RD_IMPLICIT ? APP_RD_IMPLICIT_STEPS : 20;
+
+uint32_t stepsOver(ReactionDiffusionScene &scene, uint32_t frame_ms, uint32_t simulated_ms) {
+  scene.begin(matrix);
+  const uint32_t before = scene.stepsRun();
+  for (uint32_t t = 0; t < simulated_ms; t += frame_ms) {
+    scene.update(frame_ms);
+  }
+  return scene.stepsRun() - before;
+}
+} // namespace
+
+void setUp() {
+  QspiFlash::setHostFile(kFlashFile);
+  remove(kFlashFile);
+}
+
+void tearDown() {}
+
+void test_steps_follow_simulated_time() {
+  static ReactionDiffusionScene scenes[3];
+  const uint32_t expected = kSimulatedMs / 33 * kStepsPer33Ms;
+  for (int i = 0; i < 3; ++i) {
+    const uint32_t steps = stepsOver(scenes[i], kFrameMs[i], kSimulatedMs);
+    char line[64];
+    snprintf(line, sizeof(line), "%lu ms frames: %lu steps", (unsigned long)kFrameMs[i],
+             (unsigned long)steps);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_EQUAL_UINT32(expected, steps);
+  }
+}
+
+// A stall longer than Engine ever reports counts as kMaxUpdateMs.
+void test_stall_is_capped() {
+  static ReactionDiffusionScene capped;
+  static ReactionDiffusionScene nominal;
+  const uint32_t stalled = stepsOver(capped, 10 * Scene::kMaxUpdateMs, 10 * Scene::kMaxUpdateMs);
+  const uint32_t limit = stepsOver(nominal, Scene::kMaxUpdateMs, Scene::kMaxUpdateMs);
+  TEST_ASSERT_EQUAL_UINT32(limit, stalled);
+  TEST_ASSERT_EQUAL_UINT32(Scene::kMaxUpdateMs * kStepsPer33Ms / 33, stalled);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_steps_follow_simulated_time);
+  RUN_TEST(test_stall_is_capped);
+  return UNITY_END();
+}
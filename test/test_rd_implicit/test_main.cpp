@@ -0,0 +1,189 @@
+// The semi-implicit RD integrator at the time step the scene claims for it:
+// dt_sim (0.5 to 0.7) times 20 / APP_RD_IMPLICIT_STEPS, with wind up to
+// the scene's cap. The field must stay bounded and smooth, the explicit
+// kernel at that dt must not, and over the same simulated time the
+// implicit field must stay close to the explicit one stepped at dt_sim.
+#include <unity.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "../RdTestField.h"
+#include "AppConfig.h"
+#include "scenes/RdImplicit.h"
+#include "scenes/RdKernels.h"
+
+namespace {
+using RdTestField::Grid;
+using RdTestField::Halo;
+using State = RdTestField::State<RdFloatCells>;
+constexpr unsigned long kSeed = 2468;
+constexpr int kExplicitSteps = 20;
+constexpr int kImplicitSteps = APP_RD_IMPLICIT_STEPS;
+constexpr float kStepRatio = (float)kExplicitSteps / (float)kImplicitSteps;
+// ReactionDiffusionScene's dt_sim range and implicit wind cap.
+constexpr float kSlowDtSim = 0.5f;
+constexpr float kFastDtSim = 0.7f;
+constexpr float kMaxWind = 1.5f;
+
+State implicit_;
+State explicit_;
+RdImplicit::Scratch<Grid> scratch_;
+
+float cell(const float *field, int x, int y) {
+  return field[Halo::index((x + Grid::kWidth) % Grid::kWidth, (y + Grid::kHeight) % Grid::kHeight)];
+}
+
+struct Shape {
+  bool finite;
+  float min;
+  float max;
+  float mean_v;
+  // Mean distance of v from its four neighbours' mean: grid-scale
+  // oscillation, the signature of an unstable step, drives it up.
+  float roughness;
+};
+
+Shape measure(const State &s) {
+  Shape shape{true, 1.0f, 0.0f, 0.0f, 0.0f};
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    for (int x = 0; x < Grid::kWidth; ++x) {
+      const float u = cell(s.u, x, y);
+      const float v = cell(s.v, x, y);
+      shape.finite = shape.finite && isfinite(u) && isfinite(v);
+      shape.min = fminf(shape.min, fminf(u, v));
+      shape.max = fmaxf(shape.max, fmaxf(u, v));
+      shape.mean_v += v;
+      const float around =
+          0.25f * (cell(s.v, x - 1, y) + cell(s.v, x + 1, y) + cell(s.v, x, y - 1) + cell(s.v, x, y + 1));
+      shape.roughness += fabsf(v - around);
+    }
+  }
+  shape.mean_v /= Grid::kPixels;
+  shape.roughness /= Grid::kPixels;
+  return shape;
+}
+
+void report(const char *name, float dt, int steps, const Shape &shape) {
+  char line[128];
+  snprintf(line, sizeof(line), "%s dt=%.2f %d steps: range [%.3f, %.3f] mean v %.4f roughness %.4f", name,
+           dt, steps, shape.min, shape.max, shape.mean_v, shape.roughness);
+  TEST_MESSAGE(line);
+}
+
+void stepImplicit(const RdKernels::StepParams &p, int steps) {
+  RdKernels::Tiles<Grid, float> tiles(0.0f, 1);
+  for (int step = 0; step < steps; ++step) {
+    randomSeed(kSeed + step);
+    RdImplicit::step(p, implicit_.u, implicit_.v, scratch_, tiles, RdKernels::NoEmit());
+  }
+}
+
+void stepExplicit(const RdKernels::StepParams &p, int steps) {
+  RdKernels::Tiles<Grid, float> tiles(0.0f, 1);
+  for (int step = 0; step < steps; ++step) {
+    randomSeed(kSeed + step);
+    RdKernels::stepGrid(p, explicit_.u, explicit_.v, explicit_.ring, tiles);
+  }
+}
+
+RdKernels::StepParams params(float dt, float wind_x, float wind_y) {
+  return RdKernels::StepParams{0.037f, 0.060f, 1.0f, 0.5f, dt, wind_x, wind_y};
+}
+} // namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+// A minute of simulated time at the longest implicit step and the
+// strongest wind, in both directions.
+void test_stable_at_claimed_dt() {
+  static const float kWinds[][2] = {{0.0f, 0.0f}, {kMaxWind, 0.0f}, {-kMaxWind, kMaxWind}};
+  const float dt = kFastDtSim * kStepRatio;
+  const int steps = kImplicitSteps * 30 * 60;
+  for (const auto &wind : kWinds) {
+    RdTestField::seed(implicit_, kSeed);
+    stepImplicit(params(dt, wind[0], wind[1]), steps);
+    const Shape shape = measure(implicit_);
+    report("implicit", dt, steps, shape);
+    TEST_ASSERT_TRUE(shape.finite);
+    TEST_ASSERT_GREATER_OR_EQUAL_FLOAT(0.0f, shape.min);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.0f, shape.max);
+    // Still a pattern: neither died out nor filled the grid.
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.01f, shape.mean_v);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, shape.mean_v);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.05f, shape.roughness);
+  }
+}
+
+// The step the implicit integrator takes, handed to the explicit kernel:
+// if that were stable too, the implicit one would buy nothing.
+void test_explicit_unstable_at_claimed_dt() {
+  const float dt = kFastDtSim * kStepRatio;
+  const int steps = kImplicitSteps * 30;
+  RdTestField::seed(explicit_, kSeed);
+  stepExplicit(params(dt, 0.0f, 0.0f), steps);
+  const Shape shape = measure(explicit_);
+  report("explicit", dt, steps, shape);
+  TEST_ASSERT_TRUE(!shape.finite || shape.roughness > 0.05f);
+}
+
+// Both integrators from one seed over `updates` frames' worth of simulated
+// time, the explicit one at dt_sim and the implicit one at its own dt.
+void runBoth(float dt_sim, int updates) {
+  RdTestField::seed(implicit_, kSeed);
+  RdTestField::seed(explicit_, kSeed);
+  stepImplicit(params(dt_sim * kStepRatio, 0.3f, -0.2f), kImplicitSteps * updates);
+  stepExplicit(params(dt_sim, 0.3f, -0.2f), kExplicitSteps * updates);
+}
+
+// One update, at both ends of the dt_sim range: the large steps must land
+// near where the small ones do, cell for cell.
+void test_one_update_tracks_explicit() {
+  static const float kDtSims[] = {kSlowDtSim, kFastDtSim};
+  for (float dt_sim : kDtSims) {
+    runBoth(dt_sim, 1);
+    float max_error = 0.0f;
+    float mean_error = 0.0f;
+    for (int y = 0; y < Grid::kHeight; ++y) {
+      for (int x = 0; x < Grid::kWidth; ++x) {
+        const float error = fabsf(cell(implicit_.v, x, y) - cell(explicit_.v, x, y));
+        max_error = fmaxf(max_error, error);
+        mean_error += error;
+      }
+    }
+    mean_error /= Grid::kPixels;
+    char line[96];
+    snprintf(line, sizeof(line), "dt_sim=%.2f one update: implicit vs explicit v max %.4f mean %.5f", dt_sim,
+             max_error, mean_error);
+    TEST_MESSAGE(line);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.35f, max_error);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.03f, mean_error);
+  }
+}
+
+// A simulated second: the splitting error moves individual spots, so only
+// the pattern's statistics are compared. The large steps grow v about a
+// fifth more slowly.
+void test_one_second_keeps_pattern() {
+  static const float kDtSims[] = {kSlowDtSim, kFastDtSim};
+  for (float dt_sim : kDtSims) {
+    runBoth(dt_sim, 30);
+    const Shape implicit_shape = measure(implicit_);
+    const Shape explicit_shape = measure(explicit_);
+    report("implicit", dt_sim * kStepRatio, kImplicitSteps * 30, implicit_shape);
+    report("explicit", dt_sim, kExplicitSteps * 30, explicit_shape);
+    TEST_ASSERT_FLOAT_WITHIN(0.25f * explicit_shape.mean_v, explicit_shape.mean_v, implicit_shape.mean_v);
+    TEST_ASSERT_FLOAT_WITHIN(0.4f * explicit_shape.roughness, explicit_shape.roughness, implicit_shape.roughness);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_stable_at_claimed_dt);
+  RUN_TEST(test_explicit_unstable_at_claimed_dt);
+  RUN_TEST(test_one_update_tracks_explicit);
+  RUN_TEST(test_one_second_keeps_pattern);
+  return UNITY_END();
+}
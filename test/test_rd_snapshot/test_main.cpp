@@ -0,0 +1,252 @@
+// RD snapshots through the file-backed QSPI emulation: round trip, a write
+// torn before its header, and how well a seeded field compresses.
+#include <unity.h>
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Geometry.h"
+#include "QspiFlash.h"
+#include "scenes/RdSnapshot.h"
+
+namespace {
+using Grid = Geometry<64, 32>;
+using Halo = HaloGeometry<Grid>;
+using Cell = RdSnapshot::Cell;
+constexpr uint32_t kRawBytes = 2 * Grid::kPixels;
+// Half a quantisation step, plus float rounding.
+constexpr float kQuantError = 0.5f / 255.0f + 1e-6f;
+constexpr const char *kFlashFile = "qspi_test_rd_snapshot.bin";
+
+Cell u_[Halo::kCells];
+Cell v_[Halo::kCells];
+Cell restored_u_[Halo::kCells];
+Cell restored_v_[Halo::kCells];
+uint8_t staging_[kRawBytes];
+
+char last_log_[96];
+
+void captureLog(const char *line) {
+  strncpy(last_log_, line, sizeof(last_log_) - 1);
+}
+
+uint32_t nowUs() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Times restore() in microseconds rather than the scene's milliseconds.
+const RdSnapshot::Hooks kHooks{captureLog, nowUs};
+
+RdSnapshot::Field field() {
+  return RdSnapshot::Field{u_, v_, Grid::kWidth, Grid::kHeight, Halo::kStride};
+}
+
+RdSnapshot::Field restoredField() {
+  return RdSnapshot::Field{restored_u_, restored_v_, Grid::kWidth, Grid::kHeight, Halo::kStride};
+}
+
+// The scene's seed: u = 1, v = 0 with a few squares of v.
+void seed(int offset) {
+  for (uint32_t i = 0; i < Halo::kCells; ++i) {
+    u_[i] = RdCells::fromFloat(1.0f);
+    v_[i] = RdCells::fromFloat(0.0f);
+  }
+  for (int n = 0; n < 5; ++n) {
+    const int cx = (offset + 13 * n) % (Grid::kWidth - 8);
+    const int cy = (offset + 7 * n) % (Grid::kHeight - 8);
+    for (int y = cy; y < cy + 6; ++y) {
+      for (int x = cx; x < cx + 6; ++x) {
+        u_[Halo::index(x, y)] = RdCells::fromFloat(0.5f);
+        v_[Halo::index(x, y)] = RdCells::fromFloat(0.25f);
+      }
+    }
+  }
+}
+
+// Every cell different: a worst case for the run-length coder.
+void gradient() {
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    for (int x = 0; x < Grid::kWidth; ++x) {
+      u_[Halo::index(x, y)] = RdCells::fromFloat(0.2f + 0.6f * (float)((x * 7 + y * 3) % 64) / 64.0f);
+      v_[Halo::index(x, y)] = RdCells::fromFloat(0.3f * (float)((x * x + y) % 32) / 32.0f);
+    }
+  }
+}
+
+RdSnapshot::Params params(float phase) {
+  return RdSnapshot::Params{0.037f, 0.060f, 1.0f, 0.5f, 0.5f, phase};
+}
+
+// Polls a writer through one whole snapshot, or up to its header only.
+void write(RdSnapshot::Writer &writer, float phase, bool tear) {
+  writer.poll(0, field(), params(phase));
+  TEST_ASSERT_TRUE(writer.stage() != RdSnapshot::Writer::Stage::kWait);
+  for (int polls = 0; writer.stage() != RdSnapshot::Writer::Stage::kWait; ++polls) {
+    TEST_ASSERT_LESS_THAN(1000, polls);
+    if (tear && writer.stage() == RdSnapshot::Writer::Stage::kHeader) {
+      return;
+    }
+    writer.poll(0, field(), params(phase));
+  }
+}
+
+float maxError() {
+  float error = 0.0f;
+  for (int y = 0; y < Grid::kHeight; ++y) {
+    for (int x = 0; x < Grid::kWidth; ++x) {
+      const uint32_t i = Halo::index(x, y);
+      error = fmaxf(error, fabsf(RdCells::toFloat(u_[i]) - RdCells::toFloat(restored_u_[i])));
+      error = fmaxf(error, fabsf(RdCells::toFloat(v_[i]) - RdCells::toFloat(restored_v_[i])));
+    }
+  }
+  return error;
+}
+} // namespace
+
+void setUp() {
+  QspiFlash::setHostFile(kFlashFile);
+  TEST_ASSERT_TRUE(QspiFlash::begin());
+  for (uint32_t addr = 0; addr < QspiFlash::size(); addr += QspiFlash::kSectorBytes) {
+    QspiFlash::startErase(addr);
+  }
+  last_log_[0] = '\0';
+}
+
+void tearDown() {}
+
+void test_round_trip() {
+  gradient();
+  RdSnapshot::Writer writer(0, staging_, sizeof(staging_), kHooks);
+  write(writer, 0.25f, false);
+
+  RdSnapshot::Params restored{};
+  TEST_ASSERT_TRUE(RdSnapshot::restore(restoredField(), restored, kHooks));
+  TEST_ASSERT_LESS_OR_EQUAL_FLOAT(kQuantError, maxError());
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.25f, restored.phase);
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.037f, restored.feed);
+  TEST_MESSAGE(last_log_);
+}
+
+// The field staged when the payload starts is what gets restored, however
+// the field moves on while the payload is written.
+void test_snapshot_is_one_state() {
+  gradient();
+  RdSnapshot::Writer writer(0, staging_, sizeof(staging_), kHooks);
+  writer.poll(0, field(), params(0.0f));
+  while (writer.stage() == RdSnapshot::Writer::Stage::kErase) {
+    writer.poll(0, field(), params(0.0f));
+  }
+  static Cell staged_u[Halo::kCells];
+  static Cell staged_v[Halo::kCells];
+  memcpy(staged_u, u_, sizeof(u_));
+  memcpy(staged_v, v_, sizeof(v_));
+  seed(3);
+  while (writer.stage() != RdSnapshot::Writer::Stage::kWait) {
+    writer.poll(0, field(), params(1.0f));
+  }
+  memcpy(u_, staged_u, sizeof(u_));
+  memcpy(v_, staged_v, sizeof(v_));
+
+  RdSnapshot::Params restored{};
+  TEST_ASSERT_TRUE(RdSnapshot::restore(restoredField(), restored, kHooks));
+  TEST_ASSERT_LESS_OR_EQUAL_FLOAT(kQuantError, maxError());
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.0f, restored.phase);
+}
+
+// A reset between payload and header leaves a slot that never validates;
+// restore() takes the snapshot before it.
+void test_torn_write_falls_back() {
+  RdSnapshot::Writer writer(0, staging_, sizeof(staging_), kHooks);
+  gradient();
+  write(writer, 0.5f, false);
+  seed(5);
+  write(writer, 0.75f, true);
+
+  gradient();
+  RdSnapshot::Params restored{};
+  TEST_ASSERT_TRUE(RdSnapshot::restore(restoredField(), restored, kHooks));
+  TEST_ASSERT_LESS_OR_EQUAL_FLOAT(kQuantError, maxError());
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.5f, restored.phase);
+  TEST_ASSERT_TRUE(strstr(last_log_, "seq=0 ") != nullptr);
+
+  // The next writer starts after the last complete snapshot and wins again.
+  RdSnapshot::Writer next(0, staging_, sizeof(staging_), kHooks);
+  write(next, 0.9f, false);
+  TEST_ASSERT_TRUE(RdSnapshot::restore(restoredField(), restored, kHooks));
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.9f, restored.phase);
+  TEST_ASSERT_TRUE(strstr(last_log_, "seq=1 ") != nullptr);
+}
+
+// A corrupted payload fails its CRC and the previous snapshot is used.
+void test_corrupt_payload_falls_back() {
+  RdSnapshot::Writer writer(0, staging_, sizeof(staging_), kHooks);
+  gradient();
+  write(writer, 0.5f, false);
+  write(writer, 0.75f, false);
+
+  // Slot 1's payload starts on its second page. NOR programming can only
+  // clear bits; clearing one is enough to break the CRC.
+  uint32_t slot_bytes = 0;
+  uint8_t page[QspiFlash::kPageBytes];
+  for (uint32_t addr = QspiFlash::kSectorBytes; addr < QspiFlash::size(); addr += QspiFlash::kSectorBytes) {
+    QspiFlash::read(addr, page, 4);
+    if (memcmp(page, "RDS1", 4) == 0) {
+      slot_bytes = addr;
+      break;
+    }
+  }
+  TEST_ASSERT_GREATER_THAN_UINT32(0, slot_bytes);
+  QspiFlash::read(slot_bytes + QspiFlash::kPageBytes, page, sizeof(page));
+  uint32_t i = 0;
+  while (i < sizeof(page) && page[i] == 0) {
+    ++i;
+  }
+  TEST_ASSERT_LESS_THAN_UINT32(sizeof(page), i);
+  page[i] = (uint8_t)(page[i] & (page[i] - 1));
+  QspiFlash::startProgram(slot_bytes + QspiFlash::kPageBytes + i, page + i, 1);
+
+  RdSnapshot::Params restored{};
+  TEST_ASSERT_TRUE(RdSnapshot::restore(restoredField(), restored, kHooks));
+  TEST_ASSERT_FLOAT_WITHIN(0.0f, 0.5f, restored.phase);
+}
+
+void test_compression_ratio() {
+  char line[96];
+  seed(0);
+  RdSnapshot::Writer writer(0, staging_, sizeof(staging_), kHooks);
+  write(writer, 0.0f, false);
+  const uint32_t seeded = writer.payloadBytes();
+  snprintf(line, sizeof(line), "seeded field: %lu/%lu bytes (%.1f%%)", (unsigned long)seeded,
+           (unsigned long)kRawBytes, 100.0 * seeded / kRawBytes);
+  TEST_MESSAGE(line);
+  TEST_ASSERT_LESS_THAN_UINT32(kRawBytes / 4, seeded);
+
+  gradient();
+  write(writer, 0.0f, false);
+  const uint32_t busy = writer.payloadBytes();
+  snprintf(line, sizeof(line), "gradient field: %lu/%lu bytes (%.1f%%)", (unsigned long)busy,
+           (unsigned long)kRawBytes, 100.0 * busy / kRawBytes);
+  TEST_MESSAGE(line);
+  // Worst case is one token byte per 128 literals.
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(kRawBytes + kRawBytes / 128 + 1, busy);
+
+  RdSnapshot::Params restored{};
+  const uint32_t start_us = nowUs();
+  TEST_ASSERT_TRUE(RdSnapshot::restore(restoredField(), restored, kHooks));
+  snprintf(line, sizeof(line), "restore: %lu us", (unsigned long)(nowUs() - start_us));
+  TEST_MESSAGE(line);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_snapshot_is_one_state);
+  RUN_TEST(test_torn_write_falls_back);
+  RUN_TEST(test_corrupt_payload_falls_back);
+  RUN_TEST(test_compression_ratio);
+  return UNITY_END();
+}
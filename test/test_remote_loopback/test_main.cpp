@@ -0,0 +1,185 @@
+// End-to-end remote rendering over loopback UDP: a real scene rendered and
+// encoded by FrameCodec, sent through one UdpTransport and reassembled by
+// RemoteFrameReceiver on another.
+#include <unity.h>
+
+#include <string.h>
+#include <vector>
+
+#include "AppConfig.h"
+#include "BoardConfig.h"
+#include "net/FrameCodec.h"
+#include "net/RemoteFrameReceiver.h"
+#include "net/UdpTransport.h"
+#include "scenes/CurlNoiseScene.h"
+
+namespace {
+constexpr uint16_t kPort = 47568;
+constexpr uint32_t kPixels = RemoteFrameReceiver::kPixels;
+
+using Packet = std::vector<uint8_t>;
+using Packets = std::vector<Packet>;
+
+struct Loopback {
+  UdpTransport sender;
+  UdpTransport receiver_transport;
+  RemoteFrameReceiver receiver{receiver_transport};
+  uint32_t now_ms = 1000;
+};
+
+Loopback *loop_;
+CurlNoiseScene *scene_;
+uint16_t reference_[kPixels];
+uint16_t frames_[8][kPixels];
+
+void collect(const uint8_t *packet, size_t len, void *ctx) {
+  static_cast<Packets *>(ctx)->emplace_back(packet, packet + len);
+}
+
+// Renders the next scene frame into `out` and returns its packets.
+Packets renderAndEncode(FrameCodec::Encoder &encoder, uint16_t *out, bool key) {
+  RenderTarget target{kMatrixWidth, kMatrixHeight, PixelFormat::kRgb565, out, nullptr, nullptr, 0};
+  scene_->update(33);
+  scene_->render(target);
+  Packets packets;
+  encoder.encode(out, key, collect, &packets);
+  return packets;
+}
+
+// Sends `packets` in the given order and ticks the receiver until they have
+// all arrived (loopback delivery is not instant).
+void deliver(const Packets &packets, const std::vector<size_t> &order) {
+  const uint32_t before = loop_->receiver.stats().packets;
+  for (size_t i : order) {
+    TEST_ASSERT_TRUE(loop_->sender.send(packets[i].data(), packets[i].size()));
+  }
+  const uint32_t start = millis();
+  while (loop_->receiver.stats().packets - before < order.size() && millis() - start < 1000) {
+    loop_->receiver.tick(loop_->now_ms);
+    delay(1);
+  }
+  TEST_ASSERT_EQUAL_UINT32(order.size(), loop_->receiver.stats().packets - before);
+}
+
+void deliver(const Packets &packets) {
+  std::vector<size_t> order;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    order.push_back(i);
+  }
+  deliver(packets, order);
+}
+} // namespace
+
+void setUp() {
+  loop_ = new Loopback();
+  TEST_ASSERT_TRUE(loop_->receiver_transport.begin(kPort));
+  TEST_ASSERT_TRUE(loop_->sender.begin(0));
+  TEST_ASSERT_TRUE(loop_->sender.setPeer("127.0.0.1", kPort));
+  loop_->receiver.begin(kPort);
+  scene_ = new CurlNoiseScene(CurlNoiseScene::Resume{12.5f});
+  scene_->begin(matrix);
+}
+
+void tearDown() {
+  delete scene_;
+  delete loop_;
+}
+
+// Frames come out of the jitter buffer intact and in order, one behind.
+void test_frames_round_trip() {
+  FrameCodec::Encoder encoder(kMatrixWidth, kMatrixHeight, reference_);
+  for (int i = 0; i < 6; ++i) {
+    deliver(renderAndEncode(encoder, frames_[i], i == 0));
+    TEST_ASSERT_EQUAL_UINT32(i + 1, loop_->receiver.stats().frames);
+    const uint16_t *shown = loop_->receiver.present();
+    if (i + 1 < APP_REMOTE_JITTER_FRAMES) {
+      TEST_ASSERT_NULL(shown);
+    } else {
+      TEST_ASSERT_NOT_NULL(shown);
+      TEST_ASSERT_EQUAL_UINT16_ARRAY(frames_[i + 1 - APP_REMOTE_JITTER_FRAMES], shown, kPixels);
+    }
+    loop_->now_ms += 33;
+  }
+  TEST_ASSERT_TRUE(loop_->receiver.active(loop_->now_ms));
+  TEST_ASSERT_EQUAL_UINT32(0, loop_->receiver.stats().dropped_frames);
+  TEST_ASSERT_EQUAL_UINT32(0, loop_->receiver.stats().bad_packets);
+}
+
+// A lost frame breaks the delta chain: later deltas are dropped until the
+// next key frame, which is then shown exactly.
+void test_sequence_gap_drops_deltas_until_key_frame() {
+  FrameCodec::Encoder encoder(kMatrixWidth, kMatrixHeight, reference_);
+  deliver(renderAndEncode(encoder, frames_[0], true));
+  deliver(renderAndEncode(encoder, frames_[1], false));
+  renderAndEncode(encoder, frames_[2], false); // lost
+  deliver(renderAndEncode(encoder, frames_[3], false));
+  deliver(renderAndEncode(encoder, frames_[4], false));
+  TEST_ASSERT_EQUAL_UINT32(2, loop_->receiver.stats().frames);
+  TEST_ASSERT_EQUAL_UINT32(2, loop_->receiver.stats().dropped_frames);
+
+  deliver(renderAndEncode(encoder, frames_[5], true));
+  deliver(renderAndEncode(encoder, frames_[6], false));
+  TEST_ASSERT_EQUAL_UINT32(4, loop_->receiver.stats().frames);
+  // Queue now holds the key frame and the delta after it.
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(frames_[5], loop_->receiver.present(), kPixels);
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(frames_[6], loop_->receiver.present(), kPixels);
+}
+
+// Fragments reassemble whatever order and duplication they arrive in, and
+// late fragments of a finished frame are ignored.
+void test_reordered_fragments_reassemble() {
+  FrameCodec::Encoder encoder(kMatrixWidth, kMatrixHeight, reference_);
+  const Packets key = renderAndEncode(encoder, frames_[0], true);
+  TEST_ASSERT_GREATER_THAN_UINT32(2, key.size());
+  std::vector<size_t> order;
+  for (size_t i = key.size(); i-- > 0;) {
+    order.push_back(i);
+  }
+  order.insert(order.begin() + 1, order.front()); // a duplicate
+  deliver(key, order);
+  TEST_ASSERT_EQUAL_UINT32(1, loop_->receiver.stats().frames);
+
+  const Packets delta = renderAndEncode(encoder, frames_[1], false);
+  std::vector<size_t> shuffled;
+  for (size_t i = 0; i < delta.size(); i += 2) {
+    shuffled.push_back(i);
+  }
+  for (size_t i = 1; i < delta.size(); i += 2) {
+    shuffled.push_back(i);
+  }
+  deliver(delta, shuffled);
+  deliver(key, {key.size() - 1}); // stale
+  TEST_ASSERT_EQUAL_UINT32(2, loop_->receiver.stats().frames);
+  TEST_ASSERT_EQUAL_UINT32(0, loop_->receiver.stats().dropped_frames);
+
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(frames_[0], loop_->receiver.present(), kPixels);
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(frames_[1], loop_->receiver.present(), kPixels);
+}
+
+// The stream counts as lost after APP_REMOTE_TIMEOUT_MS without a frame, and
+// a restarted sender (sequence back at 1) is picked up again.
+void test_fallback_timeout() {
+  FrameCodec::Encoder encoder(kMatrixWidth, kMatrixHeight, reference_);
+  for (int i = 0; i < 4; ++i) {
+    deliver(renderAndEncode(encoder, frames_[i], i == 0));
+    loop_->receiver.present();
+  }
+  TEST_ASSERT_TRUE(loop_->receiver.active(loop_->now_ms + APP_REMOTE_TIMEOUT_MS - 1));
+  TEST_ASSERT_FALSE(loop_->receiver.active(loop_->now_ms + APP_REMOTE_TIMEOUT_MS));
+
+  loop_->now_ms += APP_REMOTE_TIMEOUT_MS;
+  FrameCodec::Encoder restarted(kMatrixWidth, kMatrixHeight, reference_);
+  deliver(renderAndEncode(restarted, frames_[4], true));
+  deliver(renderAndEncode(restarted, frames_[5], false));
+  TEST_ASSERT_EQUAL_UINT32(6, loop_->receiver.stats().frames);
+  TEST_ASSERT_TRUE(loop_->receiver.active(loop_->now_ms));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_frames_round_trip);
+  RUN_TEST(test_sequence_gap_drops_deltas_until_key_frame);
+  RUN_TEST(test_reordered_fragments_reassemble);
+  RUN_TEST(test_fallback_timeout);
+  return UNITY_END();
+}
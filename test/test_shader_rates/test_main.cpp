@@ -0,0 +1,154 @@
+// Shader::renderRows() at the reduced rates against full-rate output:
+// kHalfX must repeat each evaluated column into its right neighbour, and
+// kInterlaced must shade only its field's rows and show the history for
+// the rest, whole-frame and in strips.
+#include <unity.h>
+
+#include <string.h>
+
+#include "Shader.h"
+
+namespace {
+// Odd, so the last column has no right neighbour to fill.
+constexpr uint16_t kWidth = 63;
+constexpr uint16_t kHeight = 32;
+constexpr uint32_t kPixels = (uint32_t)kWidth * kHeight;
+
+uint8_t full_[kPixels];
+uint8_t reduced_[kPixels];
+uint8_t history_[kPixels];
+uint16_t rgb_[kPixels];
+uint16_t palette_[256];
+
+// A different index for every pixel and frame, so any misplaced one shows.
+template <typename Coords>
+struct PatternShader : Shader::Base<Coords> {
+  int frame;
+  int row = 0;
+
+  void beginRow(typename Coords::Value, int y) { row = y; }
+  uint8_t operator()(typename Coords::Value, int x) const {
+    return (uint8_t)(x * 3 + row * 37 + frame * 101);
+  }
+};
+
+RenderTarget indexed(uint8_t *buf, uint16_t rows) {
+  RenderTarget target{};
+  target.width = kWidth;
+  target.height = rows;
+  target.format = PixelFormat::kIndexed8;
+  target.index = buf;
+  return target;
+}
+
+// One frame into `buf`, whole or in strips of `strip_rows` the way Engine
+// hands them out.
+template <typename Coords, Shader::Rate R = Shader::Rate::kFull>
+void render(uint8_t *buf, int frame, uint8_t field = 0, uint16_t strip_rows = kHeight) {
+  PatternShader<Coords> shader;
+  shader.frame = frame;
+  const Shader::Mapping<Coords> map = Shader::Mapping<Coords>::pixels();
+  if (strip_rows == kHeight) {
+    RenderTarget target = indexed(buf, kHeight);
+    Shader::renderRows<Coords, R>(target, 0, kHeight, map, shader, palette_, history_, field);
+    return;
+  }
+  static uint8_t strip[kPixels];
+  for (uint16_t y = 0; y < kHeight; y += strip_rows) {
+    const uint16_t rows = (uint16_t)(kHeight - y < strip_rows ? kHeight - y : strip_rows);
+    RenderTarget target = indexed(strip, rows);
+    target.row0 = y;
+    Shader::renderRows<Coords, R>(target, y, rows, map, shader, palette_, history_, field);
+    memcpy(buf + (uint32_t)y * kWidth, strip, (uint32_t)rows * kWidth);
+  }
+}
+
+void fillPalette() {
+  for (int i = 0; i < 256; ++i) {
+    palette_[i] = (uint16_t)(i * 257);
+  }
+}
+} // namespace
+
+void setUp() {
+  fillPalette();
+}
+
+void tearDown() {}
+
+template <typename Coords>
+void checkHalfX() {
+  render<Coords>(full_, 1);
+  render<Coords, Shader::Rate::kHalfX>(reduced_, 1);
+  for (uint16_t y = 0; y < kHeight; ++y) {
+    for (uint16_t x = 0; x < kWidth; ++x) {
+      TEST_ASSERT_EQUAL_UINT8(full_[y * kWidth + (x & ~1)], reduced_[y * kWidth + x]);
+    }
+  }
+}
+
+void test_half_x_repeats_even_columns() {
+  checkHalfX<Shader::FloatCoords>();
+  checkHalfX<Shader::FixedCoords>();
+}
+
+// RGB565 targets get the palette colour of the same indices.
+void test_half_x_rgb565() {
+  render<Shader::FloatCoords, Shader::Rate::kHalfX>(reduced_, 2);
+  PatternShader<Shader::FloatCoords> shader;
+  shader.frame = 2;
+  RenderTarget target{};
+  target.width = kWidth;
+  target.height = kHeight;
+  target.format = PixelFormat::kRgb565;
+  target.rgb = rgb_;
+  Shader::renderRows<Shader::FloatCoords, Shader::Rate::kHalfX>(
+      target, 0, kHeight, Shader::Mapping<Shader::FloatCoords>::pixels(), shader, palette_);
+  for (uint32_t i = 0; i < kPixels; ++i) {
+    TEST_ASSERT_EQUAL_UINT16(palette_[reduced_[i]], rgb_[i]);
+  }
+}
+
+// History primed from a full-rate frame, then two successive fields: each
+// row must show the full-rate frame that last shaded it.
+void checkInterlaced(uint16_t strip_rows) {
+  static uint8_t primed[kPixels];
+  static uint8_t first[kPixels];
+  static uint8_t second[kPixels];
+  render<Shader::FloatCoords>(primed, 9);
+  render<Shader::FloatCoords>(first, 10);
+  render<Shader::FloatCoords>(second, 11);
+
+  render<Shader::FloatCoords>(history_, 9);
+
+  render<Shader::FloatCoords, Shader::Rate::kInterlaced>(reduced_, 10, 0, strip_rows);
+  for (uint16_t y = 0; y < kHeight; ++y) {
+    const uint8_t *expected = ((y & 1) == 0 ? first : primed) + y * kWidth;
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, reduced_ + y * kWidth, kWidth);
+  }
+
+  render<Shader::FloatCoords, Shader::Rate::kInterlaced>(reduced_, 11, 1, strip_rows);
+  for (uint16_t y = 0; y < kHeight; ++y) {
+    const uint8_t *expected = ((y & 1) == 0 ? first : second) + y * kWidth;
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, reduced_ + y * kWidth, kWidth);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, history_ + y * kWidth, kWidth);
+  }
+}
+
+void test_interlaced_fields_match_full_frames() {
+  checkInterlaced(kHeight);
+}
+
+void test_interlaced_strips_match_full_frames() {
+  checkInterlaced(4);
+  checkInterlaced(3);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_half_x_repeats_even_columns);
+  RUN_TEST(test_half_x_rgb565);
+  RUN_TEST(test_interlaced_fields_match_full_frames);
+  RUN_TEST(test_interlaced_strips_match_full_frames);
+  return UNITY_END();
+}
@@ -0,0 +1,114 @@
+// Strip rendering (Scene::renderRows into a buffer holding only the strip's
+// rows, as Engine does with APP_STRIP_ROWS) against whole-frame render()
+// of the same scene state: every row must come out identical.
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "BoardConfig.h"
+#include "QspiFlash.h"
+#include "scenes/CurlNoiseScene.h"
+#include "scenes/ReactionDiffusionScene.h"
+
+namespace {
+// RD begin() restores any snapshot it finds; this binary's own flash file,
+// deleted before each test, keeps it seeding afresh.
+constexpr const char *kFlashFile = "qspi_test_strip_render.bin";
+constexpr uint32_t kPixels = (uint32_t)kMatrixWidth * kMatrixHeight;
+// Single rows, and heights that do and do not divide the frame.
+constexpr uint16_t kStripRows[] = {1, 3, 4, 8};
+
+uint16_t whole_[kPixels];
+uint16_t stripped_[kPixels];
+uint16_t strip_[kPixels];
+
+size_t pixelBytes(PixelFormat format) {
+  return format == PixelFormat::kRgb565 ? 2 : 1;
+}
+
+RenderTarget makeTarget(uint16_t width, uint16_t height, PixelFormat format, uint16_t *buf) {
+  RenderTarget target{};
+  target.width = width;
+  target.height = height;
+  target.format = format;
+  if (format == PixelFormat::kRgb565) {
+    target.rgb = buf;
+  } else {
+    target.index = reinterpret_cast<uint8_t *>(buf);
+  }
+  return target;
+}
+
+// Renders `scene` whole and then in strips of `rows`, and compares. Indexed
+// targets compare the indices and the palette each way points at.
+void compare(Scene &scene, uint16_t width, uint16_t height, PixelFormat format, uint16_t rows) {
+  const size_t row_bytes = width * pixelBytes(format);
+  memset(whole_, 0, sizeof(whole_));
+  memset(stripped_, 0xA5, sizeof(stripped_));
+
+  RenderTarget whole = makeTarget(width, height, format, whole_);
+  scene.render(whole);
+
+  RenderTarget strip = makeTarget(width, height, format, strip_);
+  for (uint16_t y = 0; y < height; y += rows) {
+    const uint16_t count = (uint16_t)(y + rows < height ? rows : height - y);
+    memset(strip_, 0x5A, sizeof(strip_));
+    strip.row0 = y;
+    scene.renderRows(strip, y, count);
+    memcpy(reinterpret_cast<uint8_t *>(stripped_) + y * row_bytes, strip_, count * row_bytes);
+    TEST_ASSERT_TRUE(strip.palette == whole.palette);
+  }
+
+  const uint8_t *a = reinterpret_cast<const uint8_t *>(whole_);
+  const uint8_t *b = reinterpret_cast<const uint8_t *>(stripped_);
+  for (uint16_t y = 0; y < height; ++y) {
+    if (memcmp(a + y * row_bytes, b + y * row_bytes, row_bytes) != 0) {
+      char line[80];
+      snprintf(line, sizeof(line), "%ux%u strips of %u: row %u differs", width, height, rows, y);
+      TEST_FAIL_MESSAGE(line);
+    }
+  }
+}
+} // namespace
+
+void setUp() {
+  QspiFlash::setHostFile(kFlashFile);
+  remove(kFlashFile);
+}
+
+void tearDown() {}
+
+// Curl at panel size and at 3/4 scale; strips start both on and between
+// its interpolation lattice rows.
+void test_curl_strips_match_whole_frame() {
+  CurlNoiseScene scene(CurlNoiseScene::Resume{12.5f});
+  scene.begin(matrix);
+  for (int frame = 0; frame < 3; ++frame) {
+    scene.update(33);
+    for (uint16_t rows : kStripRows) {
+      compare(scene, kMatrixWidth, kMatrixHeight, PixelFormat::kRgb565, rows);
+      compare(scene, kMatrixWidth * 3 / 4, kMatrixHeight * 3 / 4, PixelFormat::kRgb565, rows);
+    }
+  }
+}
+
+// RD in the scene's own render format, after its field has developed.
+void test_rd_strips_match_whole_frame() {
+  static ReactionDiffusionScene scene;
+  scene.begin(matrix);
+  for (int frame = 0; frame < 30; ++frame) {
+    scene.update(33);
+  }
+  const RenderSpec spec = scene.renderSpec();
+  for (uint16_t rows : kStripRows) {
+    compare(scene, spec.width, spec.height, spec.format, rows);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_curl_strips_match_whole_frame);
+  RUN_TEST(test_rd_strips_match_whole_frame);
+  return UNITY_END();
+}